@@ -4,10 +4,12 @@
 # API module sources
 set(TESSERACT_SRC_API
     src/api/altorenderer.cpp
+    src/api/asyncapi.cpp
     src/api/baseapi.cpp
     src/api/capi.cpp
     src/api/hocrrenderer.cpp
     src/api/lstmboxrenderer.cpp
+    src/api/pagepool.cpp
     src/api/pagerenderer.cpp
     src/api/pdfrenderer.cpp
     src/api/renderer.cpp
@@ -127,6 +129,7 @@ set(TESSERACT_SRC_CCUTIL
     src/ccutil/ambigs.cpp
     src/ccutil/bitvector.cpp
     src/ccutil/ccutil.cpp
+    src/ccutil/configbundle.cpp
     src/ccutil/errcode.cpp
     src/ccutil/indexmapbidi.cpp
     src/ccutil/params.cpp
@@ -167,6 +170,7 @@ set(TESSERACT_SRC_CLASSIFY
     src/classify/protos.cpp
     src/classify/shapeclassifier.cpp
     src/classify/shapetable.cpp
+    src/classify/templatecache.cpp
     src/classify/tessclassifier.cpp
     src/classify/trainingsample.cpp
 )
@@ -236,6 +240,7 @@ set(TESSERACT_SRC_TEXTORD
     src/textord/pithsync.cpp
     src/textord/pitsync1.cpp
     src/textord/scanedg.cpp
+    src/textord/skewfind.cpp
     src/textord/sortflts.cpp
     src/textord/strokewidth.cpp
     src/textord/tabfind.cpp
@@ -325,6 +330,7 @@ set(TESSERACT_SRC_LEGACY
     src/classify/protos.cpp
     src/classify/shapeclassifier.cpp
     src/classify/shapetable.cpp
+    src/classify/templatecache.cpp
     src/classify/tessclassifier.cpp
     src/classify/trainingsample.cpp
     src/dict/permdawg.cpp
@@ -350,6 +356,7 @@ set(TESSERACT_SRC_LEGACY
 
 # Header files
 set(TESSERACT_HDR_INCLUDE
+    include/tesseract/asyncapi.h
     include/tesseract/baseapi.h
     include/tesseract/capi.h
     include/tesseract/export.h
@@ -365,7 +372,10 @@ set(TESSERACT_HDR_INCLUDE
 
 # Internal header files
 set(TESSERACT_HDR_INTERNAL
+    src/api/pagepool.h
     src/api/pdf_ttf.h
+    src/api/renderbuf.h
+    src/api/rendermodel.h
     src/arch/dotproduct.h
     src/arch/intsimdmatrix.h
     src/arch/simddetect.h
@@ -427,6 +437,7 @@ set(TESSERACT_HDR_INTERNAL
     src/ccutil/bitvector.h
     src/ccutil/ccutil.h
     src/ccutil/clst.h
+    src/ccutil/configbundle.h
     src/ccutil/elst.h
     src/ccutil/elst2.h
     src/ccutil/errcode.h
@@ -529,6 +540,7 @@ set(TESSERACT_HDR_INTERNAL
     src/textord/pithsync.h
     src/textord/pitsync1.h
     src/textord/scanedg.h
+    src/textord/skewfind.h
     src/textord/sortflts.h
     src/textord/strokewidth.h
     src/textord/tabfind.h
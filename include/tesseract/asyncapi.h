@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// File:        asyncapi.h
+// Description: Asynchronous recognition on a pool of TessBaseAPI engines.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TESSERACT_API_ASYNCAPI_H_
+#define TESSERACT_API_ASYNCAPI_H_
+
+#include "export.h"
+
+// As in renderer.h, the threading types stay hidden in asyncapi.cpp.
+#include <functional> // for std::function
+#include <future>     // for std::future
+#include <memory>     // for std::unique_ptr
+#include <string>     // for std::string
+
+struct Pix;
+
+namespace tesseract {
+
+class TessBaseAPI;
+
+/**
+ * The result of a job submitted with TessAsyncAPI::Submit(Pix *).
+ */
+struct TessAsyncResult {
+  bool ok = false;         ///< False if recognition failed.
+  std::string text;        ///< The UTF-8 text, as from GetUTF8Text.
+  int mean_confidence = 0; ///< As from MeanTextConf.
+};
+
+/**
+ * Recognizes images asynchronously on a bounded pool of worker threads,
+ * each with its own engine initialized like a given TessBaseAPI.
+ * Jobs are started in the order they are submitted but may complete in any
+ * order. Submit blocks while too many jobs are waiting for a worker, so a
+ * fast producer cannot queue unbounded work.
+ * All methods may be called from any thread.
+ */
+class TESS_API TessAsyncAPI {
+public:
+  /**
+   * Called on a worker thread when a job is done. api holds the results
+   * of the job, which can be read with any of its Get* methods, but only
+   * until the callback returns. ok is false if recognition failed.
+   * An exception thrown by the callback is caught and logged.
+   */
+  using Callback = std::function<void(TessBaseAPI *api, bool ok)>;
+
+  TessAsyncAPI();
+  /** Waits for all submitted jobs, then stops the workers. */
+  ~TessAsyncAPI();
+  TessAsyncAPI(const TessAsyncAPI &) = delete;
+  TessAsyncAPI &operator=(const TessAsyncAPI &) = delete;
+
+  /**
+   * Starts num_workers workers (0 for one per hardware thread), each with
+   * an engine initialized from api with TessBaseAPI::InitFrom, so they use
+   * its languages and current parameter values. At most max_pending jobs
+   * (at least 1) wait for a free worker before Submit blocks.
+   * Returns false if an engine could not be initialized or the workers were
+   * already started.
+   */
+  bool Start(const TessBaseAPI &api, int num_workers, int max_pending);
+
+  /**
+   * Queues pix for recognition, taking ownership of it, and calls callback
+   * when done. Returns false, destroying pix, if the workers are not
+   * running. Called from a callback, it does not wait for room in the
+   * queue, which could deadlock, but returns false if there is none.
+   */
+  bool Submit(Pix *pix, Callback callback);
+
+  /**
+   * Queues pix for recognition, taking ownership of it. The returned future
+   * becomes ready with the text and confidence of the image, or with the
+   * exception thrown while reading them.
+   */
+  std::future<TessAsyncResult> Submit(Pix *pix);
+
+  /** Waits until all jobs submitted so far have completed. */
+  void Wait();
+
+  /** Returns the number of running workers. */
+  int NumWorkers() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_API_ASYNCAPI_H_
@@ -30,6 +30,9 @@
 #include <tesseract/version.h>
 
 #include <cstdio>
+#include <iosfwd> // for std::ostream
+#include <memory> // for std::unique_ptr
+#include <string> // for std::string
 #include <vector> // for std::vector
 
 struct Pix;
@@ -54,6 +57,8 @@ class LTRResultIterator;
 class ResultIterator;
 class MutableIterator;
 class TessResultRenderer;
+struct FrameStrips;
+struct RenderModel;
 class Tesseract;
 
 // Function to read a std::vector<char> from a whole file.
@@ -65,6 +70,107 @@ using DictFunc = int (Dict::*)(void *, const UNICHARSET &, UNICHAR_ID,
 using ProbabilityInContextFunc = double (Dict::*)(const char *, const char *,
                                                   int, const char *, int);
 
+/**
+ * One recognized symbol of a RecognizeLines result. The box is in the
+ * coordinates of the line image (top-left origin, right/bottom exclusive)
+ * and spans the full height of the line. The symbol text is
+ * text_length bytes at text_offset in the text of its line.
+ */
+struct TessLineSymbol {
+  int left;
+  int top;
+  int right;
+  int bottom;
+  float confidence;
+  int text_offset;
+  int text_length;
+};
+
+/**
+ * The result of one line image of RecognizeLines. The symbols of the line
+ * are num_symbols entries starting at first_symbol in the symbol array,
+ * when one was requested.
+ */
+struct TessLineResult {
+  std::string text;
+  float confidence;
+  int first_symbol;
+  int num_symbols;
+};
+
+/**
+ * The result of one rectangle of RecognizeRegions.
+ */
+struct TessRegionResult {
+  bool ok;
+  std::string text;
+  int mean_confidence;
+};
+
+/**
+ * The elements of one level of a TessFlatResult as parallel arrays, one
+ * entry per element in iteration order. Boxes are in image coordinates
+ * (top-left origin, right/bottom exclusive) and confidences in the range
+ * 0..100. The text of an element is text_length bytes at text_offset in
+ * the text of the TessFlatResult. parent is the index of the enclosing
+ * element one level up, or -1 for blocks.
+ */
+struct TessFlatLevel {
+  std::vector<int> left;
+  std::vector<int> top;
+  std::vector<int> right;
+  std::vector<int> bottom;
+  std::vector<float> confidence;
+  std::vector<int> text_offset;
+  std::vector<int> text_length;
+  std::vector<int> parent;
+
+  size_t size() const {
+    return left.size();
+  }
+  void clear() {
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+    confidence.clear();
+    text_offset.clear();
+    text_length.clear();
+    parent.clear();
+  }
+};
+
+/**
+ * All recognition results of a page in flat arrays, filled by
+ * GetFlatResult. The text holds the symbols in reading order, with words
+ * separated by a space, lines by a newline and blocks by an empty line.
+ * Each line also has its baseline, from (x1, y1) to (x2, y2).
+ * A result may be reused for the next page, keeping its memory.
+ */
+struct TessFlatResult {
+  std::string text;
+  TessFlatLevel blocks;
+  TessFlatLevel lines;
+  TessFlatLevel words;
+  TessFlatLevel symbols;
+  std::vector<int> baseline_x1;
+  std::vector<int> baseline_y1;
+  std::vector<int> baseline_x2;
+  std::vector<int> baseline_y2;
+
+  void clear() {
+    text.clear();
+    blocks.clear();
+    lines.clear();
+    words.clear();
+    symbols.clear();
+    baseline_x1.clear();
+    baseline_y1.clear();
+    baseline_x2.clear();
+    baseline_y2.clear();
+  }
+};
+
 /**
  * Base class for all tesseract APIs.
  * Specific classes can add ability to work on different inputs or produce
@@ -214,6 +320,16 @@ public:
            const std::vector<std::string> *vars_values,
            bool set_only_non_debug_params, FileReader reader);
 
+  /**
+   * Initializes this instance to recognize like the given initialized
+   * instance: same datapath, languages, engine mode and FileReader, and the
+   * same current parameter values. Use it to create engines for parallel
+   * threads. The given instance must have been initialized from a datapath
+   * rather than from in-memory data.
+   * Returns zero on success and -1 on failure.
+   */
+  int InitFrom(const TessBaseAPI &api);
+
   /**
    * Returns the languages string used in the last valid initialization.
    * If the last initialization specified "deu+hin" then that will be
@@ -289,6 +405,24 @@ public:
    */
   void ClearAdaptiveClassifier();
 
+  /**
+   * Saves what the adaptive classifier has learned so far for the given
+   * client-chosen document class (e.g. a form type), so that later jobs
+   * with the same kind of documents can start from it. The templates are
+   * written to <classify_adapted_templates_dir>/<document_class>.<lang>.a
+   * for each loaded language. Returns false on failure.
+   */
+  bool SaveAdaptedTemplates(const char *document_class);
+
+  /**
+   * Loads the adapted templates saved for the given document class. If
+   * merge is true, they only fill in characters that have not been adapted
+   * yet, otherwise they replace the current adaptive data. Templates saved
+   * with a different traineddata are rejected. Returns false if nothing
+   * could be loaded for some language.
+   */
+  bool LoadAdaptedTemplates(const char *document_class, bool merge);
+
   /**
    * @defgroup AdvancedAPI Advanced API
    * The following methods break TesseractRect into pieces, so you can
@@ -317,6 +451,15 @@ public:
    */
   void SetImage(Pix *pix);
 
+  /**
+   * As SetImage(Pix *), but without taking a copy of the image when it is
+   * already binary, 8 bit grey or 32 bit RGB without a colormap: the pixels
+   * are then thresholded and recognized in place. The caller may destroy its
+   * own reference to pix, but must not modify the pixels until the next
+   * SetImage, Clear or End. Other formats are converted as by SetImage.
+   */
+  void SetImageBorrowed(Pix *pix);
+
   /**
    * Set the resolution of the source image in pixels per inch so font size
    * information can be calculated in results.  Call this after SetImage().
@@ -342,6 +485,23 @@ public:
    */
   float GetGradient();
 
+  /**
+   * Estimate the skew of the text lines of the image from SetImage without
+   * layout analysis, from the connected components of a reduced copy of
+   * the thresholded image. Thresholds the image if needed, but leaves any
+   * recognition results alone.
+   * On success *angle is the angle of the text lines in degrees, positive
+   * if they rise to the right, so that rotating the image clockwise by
+   * *angle straightens them, and *confidence in [0, 1] is the fraction of
+   * the text that agrees with it.
+   * The text lines may also run down the page, as with vertical CJK text or
+   * a page turned by 90 degrees. If vertical is not null, *vertical is then
+   * set to true, and *angle is that of the lines once the image is turned
+   * 90 degrees anticlockwise.
+   * Returns false if there is no image or too little text to tell.
+   */
+  bool EstimateSkew(float *angle, float *confidence, bool *vertical = nullptr);
+
   /**
    * Get the result of page layout analysis as a leptonica-style
    * Boxa, Pixa pair, in reading order.
@@ -449,9 +609,90 @@ public:
    * internal structures. Returns 0 on success.
    * Optional. The Get*Text functions below will call Recognize if needed.
    * After Recognize, the output is kept internally until the next SetImage.
+   * With tessedit_time_budget_msecs set, the budget starts with each call.
    */
   int Recognize(ETEXT_DESC *monitor);
 
+  /**
+   * Returns the RecognitionDegradation flags of the settings that the last
+   * Recognize dropped to keep to tessedit_time_budget_msecs, or 0 if it
+   * dropped none. Valid until the results are cleared.
+   */
+  int GetDegradations() const;
+
+  /**
+   * Recognize each of the given images as a single text line with the LSTM
+   * recognizer, without thresholding, layout analysis or any page results.
+   * Intended for many small crops of text lines that were found by other
+   * means. Fills results with one entry per input image, in order, with the
+   * words of each line separated by single spaces and confidences in the
+   * range 0..100. If symbols is not nullptr, it is filled with the symbols
+   * of all lines, referenced from results by first_symbol and num_symbols.
+   * The images are not modified or taken over, and the current image and
+   * recognition results are left untouched.
+   * With several languages, each line is recognized by the LSTM model of
+   * each of them, and the result with the best mean word certainty is kept.
+   * Returns false if no language was initialized with an LSTM model, as
+   * with OEM_TESSERACT_ONLY or legacy-only traineddata.
+   */
+  bool RecognizeLines(const std::vector<Pix *> &lines,
+                      std::vector<TessLineResult> *results,
+                      std::vector<TessLineSymbol> *symbols = nullptr);
+
+  /**
+   * Recognize a list of rectangles of the image from SetImage, as if each
+   * was given to SetRectangle and recognized in turn, but with the whole
+   * image thresholded only once. Each rectangle therefore shares the
+   * threshold of the page instead of getting its own.
+   * num_engines > 1 recognizes the rectangles concurrently on this instance
+   * and num_engines - 1 engines initialized with InitFrom; 0 means one
+   * engine per hardware thread.
+   * Fills results with one entry per box of regions, in order. A rectangle
+   * that is outside the image or fails to recognize has ok set to false.
+   * Afterwards the rectangle is reset to the full image and there are no
+   * recognition results, as after SetImage.
+   * Returns false if there is no image or Init has not been called.
+   */
+  bool RecognizeRegions(Boxa *regions, int num_engines,
+                        std::vector<TessRegionResult> *results);
+
+  /**
+   * Recognize a very large image from SetImage in horizontal strips of
+   * strip_height rows, each overlapping the next by overlap rows, and
+   * fill result as GetFlatResult would for the whole image.
+   * Only one strip is thresholded and laid out at a time, so the working
+   * images and page layout stay proportional to the strip instead of the
+   * page; with SetImageBorrowed the page itself is not copied either.
+   * A word found in two strips is kept from the strip whose half of the
+   * overlap holds its vertical centre, so overlap should be at least the
+   * height of the tallest text line. Each strip starts new blocks.
+   * Afterwards the rectangle is reset to the full image and there are no
+   * recognition results, as after SetImage.
+   * Returns false if there is no image, Init has not been called,
+   * strip_height is not more than twice overlap or a strip fails.
+   */
+  bool RecognizeStrips(int strip_height, int overlap, TessFlatResult *result);
+
+  /**
+   * Recognize the image from SetImage as the next frame of a video or
+   * screen capture, in strips as RecognizeStrips, filling result as
+   * RecognizeStrips would. The results of each strip are kept with a hash
+   * of its rows, and a strip whose rows are unchanged since the previous
+   * frame reuses its results instead of being thresholded, laid out and
+   * recognized again, so a mostly static frame only costs the strips that
+   * changed. If recognized_strips is not null, it is set to the number of
+   * strips that were recognized.
+   * A frame of another size, depth or resolution, or with another
+   * strip_height or overlap, recognizes all strips again. After changing
+   * variables, call ClearFrames so that no stale results are reused.
+   * Returns false as RecognizeStrips does.
+   */
+  bool RecognizeFrame(int strip_height, int overlap, TessFlatResult *result,
+                      int *recognized_strips = nullptr);
+
+  /** Forget the strips kept by RecognizeFrame. */
+  void ClearFrames();
+
   /**
    * Methods to retrieve information after SetAndThresholdImage(),
    * Recognize() or TesseractRect(). (Recognize is called implicitly if needed.)
@@ -477,6 +718,12 @@ public:
    * If tessedit_page_number is non-negative, will only process that
    * single page. Works for multi-page tiff file, or filelist.
    *
+   * If tessedit_parallel_pages is greater than 1 (or 0 for one per
+   * hardware thread), the pages of a multi-page tiff file or filelist are
+   * recognized concurrently on this instance and that many minus one
+   * engines initialized with InitFrom. The renderer still receives the
+   * pages in order. Training modes and retry_config are always sequential.
+   *
    * Returns true if successful, false on error.
    */
   bool ProcessPages(const char *filename, const char *retry_config,
@@ -543,6 +790,13 @@ public:
    */
   char *GetHOCRText(int page_number);
 
+  /**
+   * As GetHOCRText, but writes the markup to out while walking the page
+   * instead of returning it as one string. Returns false, without writing
+   * anything, if recognition fails.
+   */
+  bool WriteHOCRText(std::ostream &out, ETEXT_DESC *monitor, int page_number);
+
   /**
    * Make an XML-formatted string with Alto markup from the internal
    * data structures.
@@ -555,6 +809,12 @@ public:
    */
   char *GetAltoText(int page_number);
 
+  /**
+   * As GetAltoText, but writes the markup to out while walking the page.
+   * Returns false, without writing anything, if recognition fails.
+   */
+  bool WriteAltoText(std::ostream &out, ETEXT_DESC *monitor, int page_number);
+
    /**
    * Make an XML-formatted string with PAGE markup from the internal
    * data structures.
@@ -567,6 +827,22 @@ public:
    */
   char *GetPAGEText(int page_number);
 
+  /**
+   * As GetPAGEText, but writes the markup to out without building it as
+   * one string first. The regions are still held until the reading order
+   * that precedes them is complete. Returns false, without writing
+   * anything, if recognition fails.
+   */
+  bool WritePAGEText(std::ostream &out, ETEXT_DESC *monitor, int page_number);
+
+  /**
+   * Fill result with the blocks, lines, words and symbols of the page,
+   * recognizing it first if needed. This is the same information as walking
+   * a ResultIterator, but without allocating a string per element.
+   * Returns false on error.
+   */
+  bool GetFlatResult(TessFlatResult *result);
+
   /**
    * Make a TSV-formatted string from the internal data structures.
    * page_number is 0-based but will appear in the output as 1-based.
@@ -668,7 +944,8 @@ public:
   /**
    * Clear any library-level memory caches.
    * There are a variety of expensive-to-load constant data structures (mostly
-   * language dictionaries) that are cached globally -- surviving the Init()
+   * language dictionaries and legacy classifier templates) that are cached
+   * globally -- surviving the Init()
    * and End() of individual TessBaseAPI's.  This function allows the clearing
    * of these caches.
    **/
@@ -784,6 +1061,9 @@ protected:
   std::string language_;             ///< Last initialized language.
   OcrEngineMode last_oem_requested_; ///< Last ocr language mode requested.
   bool recognition_done_;            ///< page_res_ contains recognition data.
+  RenderModel *render_model_;        ///< Shared by a chain of renderers.
+  bool keep_render_model_;           ///< A renderer chain is running.
+  FrameStrips *frame_strips_;        ///< The last frame of RecognizeFrame.
 
   /**
    * @defgroup ThresholderParams Thresholder Parameters
@@ -799,6 +1079,29 @@ protected:
   /* @} */
 
 private:
+  friend class TessResultRenderer;
+  // Makes GetRenderModel keep the model it builds until EndRenderModel, so
+  // that all renderers of a chain share one walk of the page. Returns false
+  // if a model is already being kept.
+  bool StartRenderModel();
+  void EndRenderModel();
+  // Returns the model of the current page, recognizing it if needed, or
+  // nullptr on error. Unless a renderer chain keeps it, the model is owned
+  // by *owner.
+  const RenderModel *GetRenderModel(ETEXT_DESC *monitor, std::unique_ptr<RenderModel> *owner);
+  // Recognizes the given rectangle of the current image, with binary, grey
+  // and thresholds images already clipped to it, taking ownership of them.
+  void RecognizeThresholdedRegion(int left, int top, int width, int height,
+                                  Pix *binary, Pix *grey, Pix *thresholds,
+                                  int resolution, TessRegionResult *result);
+  // Appends the words of the current results whose vertical centre lies in
+  // [owned_top, owned_bottom) to result, with their blocks, lines and symbols.
+  void AppendFlatResult(int owned_top, int owned_bottom, TessFlatResult *result);
+  // Recognizes the given rows of the current image and appends the words
+  // whose vertical centre lies in [owned_top, owned_bottom) to result.
+  // Returns false if recognition fails.
+  bool RecognizeStrip(int top, int height, int owned_top, int owned_bottom,
+                      TessFlatResult *result);
   // A list of image filenames gets special consideration
   bool ProcessPagesFileList(FILE *fp, std::string *buf,
                             const char *retry_config, int timeout_millisec,
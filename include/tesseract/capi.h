@@ -40,8 +40,15 @@ extern "C" {
 #endif
 
 #ifdef __cplusplus
+// Opaque to C++ callers of the C API too: asyncapi.h is only for C++ users
+// of TessAsyncAPI.
+namespace tesseract {
+class TessAsyncAPI;
+}
 typedef tesseract::TessResultRenderer TessResultRenderer;
 typedef tesseract::TessBaseAPI TessBaseAPI;
+typedef tesseract::TessAsyncAPI TessAsyncAPI;
+typedef tesseract::TessFlatResult TessFlatResult;
 typedef tesseract::PageIterator TessPageIterator;
 typedef tesseract::ResultIterator TessResultIterator;
 typedef tesseract::MutableIterator TessMutableIterator;
@@ -58,6 +65,8 @@ typedef tesseract::ETEXT_DESC ETEXT_DESC;
 #else
 typedef struct TessResultRenderer TessResultRenderer;
 typedef struct TessBaseAPI TessBaseAPI;
+typedef struct TessAsyncAPI TessAsyncAPI;
+typedef struct TessFlatResult TessFlatResult;
 typedef struct TessPageIterator TessPageIterator;
 typedef struct TessResultIterator TessResultIterator;
 typedef struct TessMutableIterator TessMutableIterator;
@@ -136,6 +145,7 @@ typedef struct ETEXT_DESC ETEXT_DESC;
 #endif
 
 typedef bool (*TessCancelFunc)(void *cancel_this, int words);
+typedef void (*TessAsyncCallback)(TessBaseAPI *api, BOOL ok, void *user_data);
 typedef bool (*TessProgressFunc)(ETEXT_DESC *ths, int left, int right, int top,
                                  int bottom);
 
@@ -303,6 +313,11 @@ TESS_API char *TessBaseAPIRect(TessBaseAPI *handle,
                                int left, int top, int width, int height);
 
 TESS_API void TessBaseAPIClearAdaptiveClassifier(TessBaseAPI *handle);
+TESS_API BOOL TessBaseAPISaveAdaptedTemplates(TessBaseAPI *handle,
+                                              const char *document_class);
+TESS_API BOOL TessBaseAPILoadAdaptedTemplates(TessBaseAPI *handle,
+                                              const char *document_class,
+                                              BOOL merge);
 
 TESS_API void TessBaseAPISetImage(TessBaseAPI *handle,
                                   const unsigned char *imagedata, int width,
@@ -322,6 +337,14 @@ TESS_API void TessBaseAPISetImage(TessBaseAPI *handle,
  */
 TESS_API void TessBaseAPISetImage2(TessBaseAPI *handle, struct Pix *pix);
 
+/**
+ * As TessBaseAPISetImage2(), but a binary, 8 bit grey or 32 bit RGB Pix
+ * is used in place instead of being copied. Its pixels must not be modified
+ * until the next SetImage, Clear or End.
+ */
+TESS_API void TessBaseAPISetImageBorrowed(TessBaseAPI *handle,
+                                          struct Pix *pix);
+
 TESS_API void TessBaseAPISetSourceResolution(TessBaseAPI *handle, int ppi);
 
 TESS_API void TessBaseAPISetRectangle(TessBaseAPI *handle, int left, int top,
@@ -329,6 +352,8 @@ TESS_API void TessBaseAPISetRectangle(TessBaseAPI *handle, int left, int top,
 
 TESS_API struct Pix *TessBaseAPIGetThresholdedImage(TessBaseAPI *handle);
 TESS_API float TessBaseAPIGetGradient(TessBaseAPI *handle);
+TESS_API BOOL TessBaseAPIEstimateSkew(TessBaseAPI *handle, float *angle,
+                                     float *confidence, BOOL *vertical);
 TESS_API struct Boxa *TessBaseAPIGetRegions(TessBaseAPI *handle,
                                             struct Pixa **pixa);
 TESS_API struct Boxa *TessBaseAPIGetTextlines(TessBaseAPI *handle,
@@ -360,6 +385,7 @@ TESS_API int TessBaseAPIGetThresholdedImageScaleFactor(
 TESS_API TessPageIterator *TessBaseAPIAnalyseLayout(TessBaseAPI *handle);
 
 TESS_API int TessBaseAPIRecognize(TessBaseAPI *handle, ETEXT_DESC *monitor);
+TESS_API int TessBaseAPIGetDegradations(const TessBaseAPI *handle);
 
 TESS_API BOOL TessBaseAPIProcessPages(TessBaseAPI *handle, const char *filename,
                                       const char *retry_config,
@@ -516,6 +542,85 @@ TESS_API void TessBaseGetBlockTextOrientations(TessBaseAPI *handle,
                                                int **block_orientation,
                                                bool **vertical_writing);
 
+/* Async API */
+
+/**
+ * Creates a pool of num_workers worker threads (0 for one per hardware
+ * thread), each with an engine initialized like the given TessBaseAPI.
+ * At most max_pending jobs wait for a free worker before
+ * TessAsyncAPISubmit blocks.
+ *
+ * The returned handle must be freed using TessAsyncAPIDelete.
+ *
+ * @return The new handle, or NULL if an engine could not be initialized.
+ */
+TESS_API TessAsyncAPI *TessAsyncAPICreate(const TessBaseAPI *handle,
+                                          int num_workers, int max_pending);
+
+/**
+ * Waits for all submitted jobs, then stops the workers and frees the handle.
+ */
+TESS_API void TessAsyncAPIDelete(TessAsyncAPI *handle);
+
+/**
+ * Queues pix for recognition, taking ownership of it. The callback is called
+ * on a worker thread with the engine holding the results, which may be read
+ * with the TessBaseAPIGet* functions until the callback returns.
+ *
+ * @return FALSE, destroying pix, if the workers are not running.
+ */
+TESS_API BOOL TessAsyncAPISubmit(TessAsyncAPI *handle, struct Pix *pix,
+                                 TessAsyncCallback callback, void *user_data);
+
+/**
+ * Waits until all jobs submitted so far have completed.
+ */
+TESS_API void TessAsyncAPIWait(TessAsyncAPI *handle);
+
+/* Flat result */
+
+/**
+ * Creates an empty result for TessBaseAPIGetFlatResult, which may be reused
+ * for any number of pages. Free it with TessFlatResultDelete.
+ */
+TESS_API TessFlatResult *TessFlatResultCreate(void);
+
+TESS_API void TessFlatResultDelete(TessFlatResult *result);
+
+/**
+ * Fills result with the blocks, lines, words and symbols of the page,
+ * recognizing it first if needed.
+ */
+TESS_API BOOL TessBaseAPIGetFlatResult(TessBaseAPI *handle,
+                                       TessFlatResult *result);
+
+/**
+ * Returns the UTF-8 text of the result, which is not null terminated
+ * inside, and stores its length in bytes in *length.
+ */
+TESS_API const char *TessFlatResultText(const TessFlatResult *result,
+                                        int *length);
+
+/**
+ * Returns the number of elements at the given level and points the arrays
+ * at their boxes, confidences, text spans and parent indices. Any array
+ * pointer may be NULL if it is not wanted. RIL_PARA has no elements.
+ * The arrays stay valid until the result is filled again or deleted.
+ */
+TESS_API int TessFlatResultLevel(const TessFlatResult *result,
+                                 TessPageIteratorLevel level, const int **left,
+                                 const int **top, const int **right,
+                                 const int **bottom, const float **confidence,
+                                 const int **text_offset,
+                                 const int **text_length, const int **parent);
+
+/**
+ * Returns the number of lines and points the arrays at their baselines.
+ */
+TESS_API int TessFlatResultBaselines(const TessFlatResult *result,
+                                     const int **x1, const int **y1,
+                                     const int **x2, const int **y2);
+
 /* Page iterator */
 
 TESS_API void TessPageIteratorDelete(TessPageIterator *handle);
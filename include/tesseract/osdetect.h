@@ -119,9 +119,12 @@ int orientation_and_script_detection(const char *filename, OSResults *,
 int os_detect(TO_BLOCK_LIST *port_blocks, OSResults *osr,
               tesseract::Tesseract *tess);
 
+// If fast, fewer blobs are tried, and detection stops once the best
+// orientation leads all the others by stop_margin.
 int os_detect_blobs(const std::vector<int> *allowed_scripts,
                     BLOBNBOX_CLIST *blob_list, OSResults *osr,
-                    tesseract::Tesseract *tess);
+                    tesseract::Tesseract *tess, bool fast = false,
+                    double stop_margin = 0.0);
 
 bool os_detect_blob(BLOBNBOX *bbox, OrientationDetector *o, ScriptDetector *s,
                     OSResults *, tesseract::Tesseract *tess);
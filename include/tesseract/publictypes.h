@@ -276,6 +276,18 @@ enum OcrEngineMode {
   OEM_COUNT                    // Number of OEMs
 };
 
+/**
+ * Flags of the settings that recognition dropped to keep to the time budget
+ * set in tessedit_time_budget_msecs, as returned by
+ * TessBaseAPI::GetDegradations.
+ */
+enum RecognitionDegradation {
+  DEGRADE_NO_INVERT = 1,       // Lines were not retried inverted.
+  DEGRADE_NO_DICT = 2,         // The LSTM search did not use the dictionary.
+  DEGRADE_NO_LATER_PASSES = 4, // Pass 2 and post-processing were skipped.
+  DEGRADE_NARROW_BEAM = 8      // The LSTM search used half the beam width.
+};
+
 } // namespace tesseract.
 
 #endif // TESSERACT_CCSTRUCT_PUBLICTYPES_H_
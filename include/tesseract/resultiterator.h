@@ -88,6 +88,12 @@ public:
    */
   virtual char *GetUTF8Text(PageIteratorLevel level) const;
 
+  /**
+   * Appends the same text as GetUTF8Text to *text, without allocating a
+   * string of its own. Returns false, appending nothing, at the end.
+   */
+  bool AppendUTF8Text(PageIteratorLevel level, std::string *text) const;
+
   /**
    * Returns the LSTM choices for every LSTM timestep for the current word.
    */
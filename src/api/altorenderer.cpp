@@ -13,14 +13,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "errcode.h" // for ASSERT_HOST
-#include "helpers.h" // for copy_string
-#include "tprintf.h" // for tprintf
+#include "errcode.h"     // for ASSERT_HOST
+#include "helpers.h"     // for copy_string
+#include "renderbuf.h"   // for RenderBuf
+#include "rendermodel.h" // for RenderModel
+#include "tprintf.h"     // for tprintf
 
 #include <tesseract/baseapi.h>
 #include <tesseract/renderer.h>
 
+#include <locale>  // for std::locale::classic
 #include <memory>
+#include <ostream> // for std::ostream
 #include <sstream> // for std::stringstream
 
 namespace tesseract {
@@ -28,15 +32,12 @@ namespace tesseract {
 /// Add coordinates to specified TextBlock, TextLine or String bounding box.
 /// Add word confidence if adding to a String bounding box.
 ///
-static void AddBoxToAlto(const ResultIterator *it, PageIteratorLevel level,
-                         std::stringstream &alto_str) {
-  int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
-
-  int hpos = left;
-  int vpos = top;
-  int height = bottom - top;
-  int width = right - left;
+static void AddBoxToAlto(const RenderBox &box, PageIteratorLevel level, float confidence,
+                         std::ostream &alto_str) {
+  int hpos = box.left;
+  int vpos = box.top;
+  int height = box.bottom - box.top;
+  int width = box.right - box.left;
 
   alto_str << " HPOS=\"" << hpos << "\"";
   alto_str << " VPOS=\"" << vpos << "\"";
@@ -44,7 +45,7 @@ static void AddBoxToAlto(const ResultIterator *it, PageIteratorLevel level,
   alto_str << " HEIGHT=\"" << height << "\"";
 
   if (level == RIL_WORD) {
-    int wc = it->Confidence(RIL_WORD);
+    int wc = confidence;
     alto_str << " WC=\"0." << wc << "\"";
   } else {
     alto_str << ">";
@@ -109,14 +110,9 @@ bool TessAltoRenderer::AddImageHandler(TessBaseAPI *api) {
     begin_document = false;
   }
 
-  const std::unique_ptr<const char[]> text(api->GetAltoText(imagenum()));
-  if (text == nullptr) {
-    return false;
-  }
-
-  AppendString(text.get());
-
-  return true;
+  RenderBuf buffer([this](const char *data, int length) { AppendData(data, length); });
+  std::ostream alto_str(&buffer);
+  return api->WriteAltoText(alto_str, nullptr, imagenum());
 }
 
 ///
@@ -145,9 +141,24 @@ char *TessBaseAPI::GetAltoText(int page_number) {
 /// data structures.
 ///
 char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
-  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(monitor) < 0)) {
+  std::stringstream alto_str;
+  if (!WriteAltoText(alto_str, monitor, page_number)) {
     return nullptr;
   }
+  return copy_string(alto_str.str());
+}
+
+///
+/// Write the ALTO markup of the page to alto_str while walking the
+/// internal data structures.
+///
+bool TessBaseAPI::WriteAltoText(std::ostream &alto_str, ETEXT_DESC *monitor,
+                                int page_number) {
+  std::unique_ptr<RenderModel> model_owner;
+  const RenderModel *model = GetRenderModel(monitor, &model_owner);
+  if (model == nullptr) {
+    return false;
+  }
 
   int lcnt = 0, tcnt = 0, bcnt = 0, wcnt = 0;
 
@@ -155,9 +166,8 @@ char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
     SetInputName(nullptr);
   }
 
-  std::stringstream alto_str;
   // Use "C" locale (needed for int values larger than 999).
-  alto_str.imbue(std::locale::classic());
+  const std::locale locale = alto_str.imbue(std::locale::classic());
   alto_str << "\t\t<Page WIDTH=\"" << rect_width_ << "\" HEIGHT=\"" << rect_height_
            << "\" PHYSICAL_IMG_NR=\"" << page_number << "\""
            << " ID=\"page_" << page_number << "\">\n"
@@ -165,35 +175,33 @@ char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
            << " WIDTH=\"" << rect_width_ << "\""
            << " HEIGHT=\"" << rect_height_ << "\">\n";
 
-  std::unique_ptr<ResultIterator> res_it(GetIterator());
-  while (!res_it->Empty(RIL_BLOCK)) {
-    if (res_it->Empty(RIL_WORD)) {
-      res_it->Next(RIL_WORD);
-      continue;
-    }
-
-    int left, top, right, bottom;
-    auto block_type = res_it->BlockType();
+  const auto &words = model->words;
+  size_t i = 0;
+  while (i < words.size()) {
+    const RenderWord &word = words[i];
 
-    switch (block_type) {
+    switch (word.block_type) {
       case PT_FLOWING_IMAGE:
       case PT_HEADING_IMAGE:
       case PT_PULLOUT_IMAGE: {
         // Handle all kinds of images.
         // TODO: optionally add TYPE, for example TYPE="photo".
         alto_str << "\t\t\t\t<Illustration ID=\"" << GetID("cblock", page_number, bcnt++) << "\"";
-        AddBoxToAlto(res_it.get(), RIL_BLOCK, alto_str);
+        AddBoxToAlto(model->blocks[word.block], RIL_BLOCK, 0, alto_str);
         alto_str << "</Illustration>\n";
-        res_it->Next(RIL_BLOCK);
+        // Skip the rest of the block.
+        while (++i < words.size() && !words[i].begins_block) {
+        }
         continue;
       }
       case PT_HORZ_LINE:
       case PT_VERT_LINE:
         // Handle horizontal and vertical lines.
         alto_str << "\t\t\t\t<GraphicalElement ID=\"" << GetID("cblock", page_number, bcnt++) << "\"";
-        AddBoxToAlto(res_it.get(), RIL_BLOCK, alto_str);
+        AddBoxToAlto(model->blocks[word.block], RIL_BLOCK, 0, alto_str);
         alto_str << "</GraphicalElement >\n";
-        res_it->Next(RIL_BLOCK);
+        while (++i < words.size() && !words[i].begins_block) {
+        }
         continue;
       case PT_NOISE:
         tprintf("TODO: Please report image which triggers the noise case.\n");
@@ -202,73 +210,58 @@ char *TessBaseAPI::GetAltoText(ETEXT_DESC *monitor, int page_number) {
         break;
     }
 
-    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
+    if (word.begins_block) {
       alto_str << "\t\t\t\t<ComposedBlock ID=\"" << GetID("cblock", page_number, bcnt) << "\"";
-      AddBoxToAlto(res_it.get(), RIL_BLOCK, alto_str);
+      AddBoxToAlto(model->blocks[word.block], RIL_BLOCK, 0, alto_str);
       alto_str << "\n";
     }
 
-    if (res_it->IsAtBeginningOf(RIL_PARA)) {
+    if (word.begins_para) {
       alto_str << "\t\t\t\t\t<TextBlock ID=\"" << GetID("block", page_number, tcnt) << "\"";
-      AddBoxToAlto(res_it.get(), RIL_PARA, alto_str);
+      AddBoxToAlto(model->paras[word.para], RIL_PARA, 0, alto_str);
       alto_str << "\n";
     }
 
-    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
+    if (word.begins_line) {
       alto_str << "\t\t\t\t\t\t<TextLine ID=\"" << GetID("line", page_number, lcnt) << "\"";
-      AddBoxToAlto(res_it.get(), RIL_TEXTLINE, alto_str);
+      AddBoxToAlto(model->lines[word.line], RIL_TEXTLINE, 0, alto_str);
       alto_str << "\n";
     }
 
     alto_str << "\t\t\t\t\t\t\t<String ID=\"" << GetID("string", page_number, wcnt) << "\"";
-    AddBoxToAlto(res_it.get(), RIL_WORD, alto_str);
-    alto_str << " CONTENT=\"";
-
-    bool last_word_in_line = res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD);
-    bool last_word_in_tblock = res_it->IsAtFinalElement(RIL_PARA, RIL_WORD);
-    bool last_word_in_cblock = res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD);
-
-    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-
-    do {
-      const std::unique_ptr<const char[]> grapheme(res_it->GetUTF8Text(RIL_SYMBOL));
-      if (grapheme && grapheme[0] != 0) {
-        alto_str << HOcrEscape(grapheme.get()).c_str();
-      }
-      res_it->Next(RIL_SYMBOL);
-    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
-
-    alto_str << "\"/>";
+    AddBoxToAlto(word.box, RIL_WORD, word.confidence, alto_str);
+    alto_str << " CONTENT=\"" << HOcrEscape(word.text.c_str()).c_str() << "\"/>";
 
     wcnt++;
 
-    if (last_word_in_line) {
+    if (word.ends_line) {
       alto_str << "\n\t\t\t\t\t\t</TextLine>\n";
       lcnt++;
     } else {
-      int hpos = right;
-      int vpos = top;
-      res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
-      int width = left - hpos;
+      int hpos = word.box.right;
+      int vpos = word.box.top;
+      int next_left = i + 1 < words.size() ? words[i + 1].box.left : word.box.left;
+      int width = next_left - hpos;
       alto_str << "<SP WIDTH=\"" << width << "\" VPOS=\"" << vpos << "\" HPOS=\"" << hpos
                << "\"/>\n";
     }
 
-    if (last_word_in_tblock) {
+    if (word.ends_para) {
       alto_str << "\t\t\t\t\t</TextBlock>\n";
       tcnt++;
     }
 
-    if (last_word_in_cblock) {
+    if (word.ends_block) {
       alto_str << "\t\t\t\t</ComposedBlock>\n";
       bcnt++;
     }
+    ++i;
   }
 
   alto_str << "\t\t\t</PrintSpace>\n"
            << "\t\t</Page>\n";
-
-  return copy_string(alto_str.str());
+  alto_str.imbue(locale);
+  return true;
 }
 
 } // namespace tesseract
@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////
+// File:        asyncapi.cpp
+// Description: Asynchronous recognition on a pool of TessBaseAPI engines.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <tesseract/asyncapi.h>
+
+#include "tprintf.h" // for tprintf
+
+#include <allheaders.h> // for pixDestroy
+#include <tesseract/baseapi.h>
+
+#include <algorithm>          // for std::max
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <exception>          // for std::exception
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+#include <vector>             // for std::vector
+
+namespace tesseract {
+
+class TessAsyncAPI::Impl {
+public:
+  ~Impl() {
+    Stop();
+  }
+
+  bool Start(const TessBaseAPI &api, int num_workers, int max_pending) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!threads_.empty()) {
+      return false;
+    }
+    if (num_workers <= 0) {
+      num_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < num_workers; ++i) {
+      auto engine = std::make_unique<TessBaseAPI>();
+      if (engine->InitFrom(api) != 0) {
+        tprintf("Error: Could not initialize async worker %d\n", i);
+        engines_.clear();
+        return false;
+      }
+      engines_.push_back(std::move(engine));
+    }
+    max_pending_ = std::max(1, max_pending);
+    stopping_ = false;
+    for (auto &engine : engines_) {
+      threads_.emplace_back(&Impl::WorkerLoop, this, engine.get());
+    }
+    return true;
+  }
+
+  bool Submit(Pix *pix, Callback callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto has_room = [this] { return queue_.size() < static_cast<size_t>(max_pending_); };
+    // A callback of this pool cannot wait for room, as its worker may be the
+    // only one that could make it.
+    bool reentrant = worker_pool_ == this;
+    if (!reentrant) {
+      queue_changed_.wait(lock, [this, &has_room] {
+        return has_room() || threads_.empty() || stopping_;
+      });
+    }
+    if (threads_.empty() || stopping_ || !has_room()) {
+      lock.unlock();
+      pixDestroy(&pix);
+      return false;
+    }
+    queue_.push_back({pix, std::move(callback)});
+    queue_changed_.notify_all();
+    return true;
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_changed_.wait(lock, [this] { return queue_.empty() && num_busy_ == 0; });
+  }
+
+  // Finishes the queued jobs and joins the workers.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    queue_changed_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.clear();
+    engines_.clear();
+  }
+
+  int NumWorkers() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+  }
+
+private:
+  struct Job {
+    Pix *pix;
+    Callback callback;
+  };
+
+  void WorkerLoop(TessBaseAPI *api) {
+    worker_pool_ = this;
+    for (;;) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queue_changed_.wait(lock, [this] { return !queue_.empty() || stopping_; });
+        if (queue_.empty()) {
+          return;
+        }
+        job = std::move(queue_.front());
+        queue_.pop_front();
+        ++num_busy_;
+      }
+      queue_changed_.notify_all();
+      api->SetImage(job.pix);
+      bool ok = api->Recognize(nullptr) == 0;
+      if (job.callback) {
+        // An exception must not escape the worker thread, which would
+        // terminate the program.
+        try {
+          job.callback(api, ok);
+        } catch (const std::exception &e) {
+          tprintf("Error: async callback failed: %s\n", e.what());
+        } catch (...) {
+          tprintf("Error: async callback failed\n");
+        }
+      }
+      api->Clear();
+      pixDestroy(&job.pix);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --num_busy_;
+      }
+      queue_changed_.notify_all();
+    }
+  }
+
+  // The pool whose worker runs on this thread, if any.
+  static inline thread_local const Impl *worker_pool_ = nullptr;
+
+  std::vector<std::unique_ptr<TessBaseAPI>> engines_;
+  std::vector<std::thread> threads_;
+
+  // Everything below is guarded by mutex_.
+  std::mutex mutex_;
+  // Signalled whenever a job is queued, started or completed, and on Stop.
+  std::condition_variable queue_changed_;
+  std::deque<Job> queue_;
+  int max_pending_ = 1;
+  int num_busy_ = 0;
+  bool stopping_ = false;
+};
+
+TessAsyncAPI::TessAsyncAPI() : impl_(new Impl) {}
+
+TessAsyncAPI::~TessAsyncAPI() = default;
+
+bool TessAsyncAPI::Start(const TessBaseAPI &api, int num_workers, int max_pending) {
+  return impl_->Start(api, num_workers, max_pending);
+}
+
+bool TessAsyncAPI::Submit(Pix *pix, Callback callback) {
+  return impl_->Submit(pix, std::move(callback));
+}
+
+std::future<TessAsyncResult> TessAsyncAPI::Submit(Pix *pix) {
+  auto promise = std::make_shared<std::promise<TessAsyncResult>>();
+  auto future = promise->get_future();
+  bool queued = impl_->Submit(pix, [promise](TessBaseAPI *api, bool ok) {
+    try {
+      TessAsyncResult result;
+      result.ok = ok;
+      if (ok) {
+        std::unique_ptr<char[]> text(api->GetUTF8Text());
+        if (text != nullptr) {
+          result.text = text.get();
+        }
+        result.mean_confidence = api->MeanTextConf();
+      }
+      promise->set_value(std::move(result));
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+  if (!queued) {
+    promise->set_value(TessAsyncResult());
+  }
+  return future;
+}
+
+void TessAsyncAPI::Wait() {
+  impl_->Wait();
+}
+
+int TessAsyncAPI::NumWorkers() const {
+  return impl_->NumWorkers();
+}
+
+} // namespace tesseract
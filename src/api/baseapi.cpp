@@ -38,17 +38,21 @@
 #include "image.h"   // for Image, Leptonica (pixDestroy, boxCreate, ...)
 #include "imageio.h" // for IFF_TIFF_G4, IFF_TIFF, IFF_TIFF_G3, ...
 #ifndef DISABLED_LEGACY_ENGINE
-#  include "intfx.h" // for INT_FX_RESULT_STRUCT
+#  include "intfx.h"         // for INT_FX_RESULT_STRUCT
+#  include "templatecache.h" // for TemplateCache
 #endif
 #include "mutableiterator.h" // for MutableIterator
 #include "normalis.h"        // for kBlnBaselineOffset, kBlnXHeight
+#include "pagepool.h"        // for PagePool
 #include "pageres.h"         // for PAGE_RES_IT, WERD_RES, PAGE_RES, CR_DE...
 #include "paragraphs.h"      // for DetectParagraphs
 #include "params.h"          // for BoolParam, IntParam, DoubleParam, Stri...
 #include "pdblock.h"         // for PDBLK
 #include "points.h"          // for FCOORD
 #include "polyblk.h"         // for POLY_BLOCK
+#include "rendermodel.h"     // for RenderModel
 #include "rect.h"            // for TBOX
+#include "skewfind.h"        // for FindTextSkew
 #include "stepblob.h"        // for C_BLOB_IT, C_BLOB, C_BLOB_LIST
 #include "tessdatamanager.h" // for TessdataManager, kTrainedDataSuffix
 #include "tesseractclass.h"  // for Tesseract
@@ -62,6 +66,9 @@
 #include <tesseract/renderer.h>       // for TessResultRenderer
 #include <tesseract/resultiterator.h> // for ResultIterator
 
+#include <algorithm> // for std::min
+#include <atomic>   // for std::atomic
+#include <climits>  // for INT_MIN, INT_MAX
 #include <cmath>    // for round, M_PI
 #include <cstdint>  // for int32_t
 #include <cstring>  // for strcmp, strcpy
@@ -73,6 +80,7 @@
 #include <set>      // for std::pair
 #include <sstream>  // for std::stringstream
 #include <string_view>
+#include <thread>   // for std::thread
 #include <vector>   // for std::vector
 
 #ifdef HAVE_LIBCURL
@@ -176,6 +184,9 @@ TessBaseAPI::TessBaseAPI()
     , page_res_(nullptr)
     , last_oem_requested_(OEM_DEFAULT)
     , recognition_done_(false)
+    , render_model_(nullptr)
+    , keep_render_model_(false)
+    , frame_strips_(nullptr)
     , rect_left_(0)
     , rect_top_(0)
     , rect_width_(0)
@@ -365,6 +376,53 @@ int TessBaseAPI::Init(const char *data, int data_size, const char *language, Ocr
   return 0;
 }
 
+// Copies the value of each non-init param in dst from the param of the same
+// name in src. Init params have already been passed to Init.
+template <class T>
+static void CopyNonInitParams(const std::vector<T *> &dst, const ParamsVectors *src) {
+  for (auto *param : dst) {
+    if (!param->is_init()) {
+      param->ResetFrom(src);
+    }
+  }
+}
+
+int TessBaseAPI::InitFrom(const TessBaseAPI &api) {
+  if (api.tesseract_ == nullptr || api.datapath_.empty()) {
+    return -1;
+  }
+  // Init params only take effect during Init, so pass their current values
+  // as variables.
+  const ParamsVectors *src_params = api.tesseract_->params();
+  std::vector<std::string> vars_vec;
+  std::vector<std::string> vars_values;
+  auto add_init_params = [&](const auto &params) {
+    for (auto *param : params) {
+      std::string value;
+      if (param->is_init() &&
+          ParamUtils::GetParamAsString(param->name_str(), src_params, &value)) {
+        vars_vec.emplace_back(param->name_str());
+        vars_values.push_back(std::move(value));
+      }
+    }
+  };
+  add_init_params(src_params->int_params);
+  add_init_params(src_params->bool_params);
+  add_init_params(src_params->string_params);
+  add_init_params(src_params->double_params);
+  output_file_ = api.output_file_;
+  if (Init(api.datapath_.c_str(), 0, api.language_.c_str(), api.last_oem_requested_, nullptr, 0,
+           &vars_vec, &vars_values, false, api.reader_) != 0) {
+    return -1;
+  }
+  ParamsVectors *params = tesseract_->params();
+  CopyNonInitParams(params->int_params, src_params);
+  CopyNonInitParams(params->bool_params, src_params);
+  CopyNonInitParams(params->string_params, src_params);
+  CopyNonInitParams(params->double_params, src_params);
+  return 0;
+}
+
 /**
  * Returns the languages string used in the last valid initialization.
  * If the last initialization specified "deu+hin" then that will be
@@ -492,6 +550,26 @@ void TessBaseAPI::ClearAdaptiveClassifier() {
   tesseract_->ResetAdaptiveClassifier();
   tesseract_->ResetDocumentDictionary();
 }
+
+/**
+ * Saves the adapted templates for the given document class.
+ */
+bool TessBaseAPI::SaveAdaptedTemplates(const char *document_class) {
+  if (tesseract_ == nullptr) {
+    return false;
+  }
+  return tesseract_->SaveAdaptedTemplates(document_class);
+}
+
+/**
+ * Loads the adapted templates saved for the given document class.
+ */
+bool TessBaseAPI::LoadAdaptedTemplates(const char *document_class, bool merge) {
+  if (tesseract_ == nullptr) {
+    return false;
+  }
+  return tesseract_->LoadAdaptedTemplates(document_class, merge);
+}
 #endif // ndef DISABLED_LEGACY_ENGINE
 
 /**
@@ -525,20 +603,37 @@ void TessBaseAPI::SetSourceResolution(int ppi) {
  * Use Pix where possible. Tesseract uses Pix as its internal representation
  * and it is therefore more efficient to provide a Pix directly.
  */
+// Removes the alpha channel of a png in place.
+static void RemovePngAlpha(Pix *pix) {
+  if (pixGetSpp(pix) == 4 && pixGetInputFormat(pix) == IFF_PNG) {
+    Pix *p1 = pixRemoveAlpha(pix);
+    pixSetSpp(p1, 3);
+    static_cast<void>(pixCopy(pix, p1));
+    pixDestroy(&p1);
+  }
+}
+
 void TessBaseAPI::SetImage(Pix *pix) {
   if (InternalSetImage()) {
-    if (pixGetSpp(pix) == 4 && pixGetInputFormat(pix) == IFF_PNG) {
-      // remove alpha channel from png
-      Pix *p1 = pixRemoveAlpha(pix);
-      pixSetSpp(p1, 3);
-      static_cast<void>(pixCopy(pix, p1));
-      pixDestroy(&p1);
-    }
+    RemovePngAlpha(pix);
     thresholder_->SetImage(pix);
     SetInputImage(thresholder_->GetPixRect());
   }
 }
 
+/**
+ * Provide an image for Tesseract to recognize without copying it, if it is
+ * in a format that Tesseract can use directly. The pixels must stay
+ * unmodified until the next SetImage, Clear or End.
+ */
+void TessBaseAPI::SetImageBorrowed(Pix *pix) {
+  if (InternalSetImage()) {
+    RemovePngAlpha(pix);
+    thresholder_->SetBorrowedImage(pix);
+    SetInputImage(thresholder_->GetPixRect());
+  }
+}
+
 /**
  * Restrict recognition to a sub-rectangle of the image. Call after SetImage.
  * Each SetRectangle clears the recognition results so multiple rectangles
@@ -763,10 +858,15 @@ int TessBaseAPI::Recognize(ETEXT_DESC *monitor) {
   if (tesseract_ == nullptr) {
     return -1;
   }
+  // Also clears what a previous page dropped, even if this one never gets
+  // to word recognition.
+  tesseract_->StartTimeBudget();
   if (FindLines() != 0) {
     return -1;
   }
   delete page_res_;
+  delete render_model_;
+  render_model_ = nullptr;
   if (block_list_->empty()) {
     page_res_ = new PAGE_RES(false, block_list_, &tesseract_->prev_word_best_choice_);
     return 0; // Empty page.
@@ -844,6 +944,401 @@ int TessBaseAPI::Recognize(ETEXT_DESC *monitor) {
   return result;
 }
 
+int TessBaseAPI::GetDegradations() const {
+  return tesseract_ != nullptr ? tesseract_->degradations() : 0;
+}
+
+/**
+ * Recognize each of the given line images directly with the LSTM recognizer,
+ * bypassing the thresholder, layout analysis and page_res_.
+ */
+bool TessBaseAPI::RecognizeLines(const std::vector<Pix *> &lines,
+                                 std::vector<TessLineResult> *results,
+                                 std::vector<TessLineSymbol> *symbols) {
+  if (tesseract_ == nullptr || results == nullptr || !tesseract_->AnyLSTMRecognizer()) {
+    return false;
+  }
+  results->clear();
+  if (symbols != nullptr) {
+    symbols->clear();
+  }
+  tesseract_->SetBlackAndWhitelist();
+  for (auto *pix : lines) {
+    TessLineResult line = {std::string(), 0.0f, 0, 0};
+    if (symbols != nullptr) {
+      line.first_symbol = symbols->size();
+    }
+    PointerVector<WERD_RES> words;
+    if (tesseract_->LSTMRecognizeLineImage(pix, &words)) {
+      int height = pixGetHeight(pix);
+      float certainty_sum = 0.0f;
+      int num_words = 0;
+      for (unsigned w = 0; w < words.size(); ++w) {
+        WERD_RES *word = words[w];
+        const WERD_CHOICE *choice = word->best_choice;
+        if (choice == nullptr || choice->empty()) {
+          continue;
+        }
+        if (num_words > 0) {
+          line.text += ' ';
+        }
+        certainty_sum += choice->certainty();
+        ++num_words;
+        C_BLOB_IT b_it(word->word->cblob_list());
+        for (unsigned i = 0; i < choice->length(); ++i) {
+          const char *unichar = choice->unicharset()->id_to_unichar_ext(choice->unichar_id(i));
+          if (symbols != nullptr) {
+            TBOX box = b_it.empty() ? word->word->bounding_box() : b_it.data()->bounding_box();
+            TessLineSymbol symbol;
+            symbol.left = box.left();
+            symbol.top = height - box.top();
+            symbol.right = box.right();
+            symbol.bottom = height - box.bottom();
+            symbol.confidence = ClipToRange(100 + 5 * choice->certainty(i), 0.0f, 100.0f);
+            symbol.text_offset = line.text.size();
+            symbol.text_length = strlen(unichar);
+            symbols->push_back(symbol);
+            ++line.num_symbols;
+          }
+          line.text += unichar;
+          if (!b_it.empty()) {
+            b_it.forward();
+          }
+        }
+      }
+      if (num_words > 0) {
+        line.confidence = ClipToRange(100 + 5 * certainty_sum / num_words, 0.0f, 100.0f);
+      }
+    }
+    results->push_back(std::move(line));
+  }
+  return true;
+}
+
+// Page images thresholded once and clipped to one rectangle.
+struct ClippedRegion {
+  int index;
+  int left, top, width, height;
+  Image binary;
+  Image grey;
+  Image thresholds;
+};
+
+/**
+ * Recognize a list of rectangles of the current image, thresholding the
+ * whole image only once.
+ */
+bool TessBaseAPI::RecognizeRegions(Boxa *regions, int num_engines,
+                                   std::vector<TessRegionResult> *results) {
+  if (tesseract_ == nullptr || thresholder_ == nullptr || thresholder_->IsEmpty() ||
+      regions == nullptr || results == nullptr) {
+    return false;
+  }
+  results->clear();
+  int num_regions = boxaGetCount(regions);
+  results->resize(num_regions, TessRegionResult{false, std::string(), 0});
+  thresholder_->GetImageSizes(&rect_left_, &rect_top_, &rect_width_, &rect_height_,
+                              &image_width_, &image_height_);
+  const int image_width = image_width_;
+  const int image_height = image_height_;
+  thresholder_->SetRectangle(0, 0, image_width, image_height);
+  ClearResults();
+  Image page_binary = nullptr;
+  if (!Threshold(&page_binary.pix_)) {
+    return false;
+  }
+  int resolution = tesseract_->source_resolution();
+  std::vector<ClippedRegion> clipped;
+  for (int r = 0; r < num_regions; ++r) {
+    Box *box = boxaGetBox(regions, r, L_CLONE);
+    Box *clip_box = boxClipToRectangle(box, image_width, image_height);
+    boxDestroy(&box);
+    if (clip_box == nullptr) {
+      continue;
+    }
+    ClippedRegion region;
+    region.index = r;
+    boxGetGeometry(clip_box, &region.left, &region.top, &region.width, &region.height);
+    region.binary = pixClipRectangle(page_binary, clip_box, nullptr);
+    region.grey = tesseract_->pix_grey() == nullptr
+                      ? nullptr
+                      : pixClipRectangle(tesseract_->pix_grey(), clip_box, nullptr);
+    region.thresholds = tesseract_->pix_thresholds() == nullptr
+                            ? nullptr
+                            : pixClipRectangle(tesseract_->pix_thresholds(), clip_box, nullptr);
+    boxDestroy(&clip_box);
+    clipped.push_back(region);
+  }
+  page_binary.destroy();
+  ClearResults();
+
+  if (num_engines <= 0) {
+    num_engines = std::thread::hardware_concurrency();
+  }
+  num_engines = std::min<int>(num_engines, clipped.size());
+  // The other engines get their own copy of the image, made before any
+  // thread starts, as leptonica reference counts are not thread safe.
+  std::vector<std::unique_ptr<TessBaseAPI>> engines;
+  for (int e = 1; e < num_engines; ++e) {
+    auto engine = std::make_unique<TessBaseAPI>();
+    if (engine->InitFrom(*this) != 0) {
+      tprintf("Warning: Failed to initialize engine %d for regions.\n", e);
+      break;
+    }
+    engine->SetImage(GetInputImage());
+    engine->SetSourceResolution(thresholder_->GetSourceYResolution());
+    engines.push_back(std::move(engine));
+  }
+  std::atomic<size_t> next_region(0);
+  auto recognize_regions = [&clipped, &next_region, resolution, results](TessBaseAPI *api) {
+    for (size_t i = next_region++; i < clipped.size(); i = next_region++) {
+      ClippedRegion &region = clipped[i];
+      api->RecognizeThresholdedRegion(region.left, region.top, region.width, region.height,
+                                      region.binary, region.grey, region.thresholds,
+                                      resolution, &(*results)[region.index]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (auto &engine : engines) {
+    threads.emplace_back(recognize_regions, engine.get());
+  }
+  recognize_regions(this);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  thresholder_->SetRectangle(0, 0, image_width, image_height);
+  ClearResults();
+  return true;
+}
+
+/**
+ * Recognize the image in overlapping horizontal strips, so that only one
+ * strip at a time is thresholded and laid out.
+ */
+bool TessBaseAPI::RecognizeStrips(int strip_height, int overlap, TessFlatResult *result) {
+  if (tesseract_ == nullptr || thresholder_ == nullptr || thresholder_->IsEmpty() ||
+      result == nullptr || overlap < 0 || strip_height <= 2 * overlap) {
+    return false;
+  }
+  result->clear();
+  thresholder_->GetImageSizes(&rect_left_, &rect_top_, &rect_width_, &rect_height_,
+                              &image_width_, &image_height_);
+  const int image_width = image_width_;
+  const int image_height = image_height_;
+  const int step = strip_height - overlap;
+  bool ok = true;
+  for (int top = 0; top < image_height; top += step) {
+    int height = std::min(strip_height, image_height - top);
+    bool last = top + height >= image_height;
+    // The seam between two strips is the middle of their overlap.
+    int owned_top = top == 0 ? 0 : top + overlap / 2;
+    int owned_bottom = last ? image_height : top + step + overlap / 2;
+    if (!RecognizeStrip(top, height, owned_top, owned_bottom, result)) {
+      ok = false;
+      break;
+    }
+    if (last) {
+      break;
+    }
+  }
+  thresholder_->SetRectangle(0, 0, image_width, image_height);
+  ClearResults();
+  return ok;
+}
+
+bool TessBaseAPI::RecognizeStrip(int top, int height, int owned_top, int owned_bottom,
+                                 TessFlatResult *result) {
+  thresholder_->SetRectangle(0, top, image_width_, height);
+  ClearResults();
+  if (Recognize(nullptr) < 0) {
+    return false;
+  }
+  AppendFlatResult(owned_top, owned_bottom, result);
+  return true;
+}
+
+// The strips of the last frame of RecognizeFrame, with the geometry that
+// they are only valid for.
+struct FrameStrips {
+  int width = 0;
+  int height = 0;
+  int depth = 0;
+  int resolution = 0;
+  int strip_height = 0;
+  int overlap = 0;
+  std::vector<uint64_t> hashes;
+  std::vector<TessFlatResult> results;
+};
+
+// Returns a FNV-1a hash of the given rows of pix.
+static uint64_t HashRows(Image pix, int top, int height) {
+  const uint64_t kFnvPrime = 0x100000001b3ULL;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  int wpl = pixGetWpl(pix);
+  const l_uint32 *data = pixGetData(pix) + wpl * top;
+  for (int i = 0; i < wpl * height; ++i) {
+    hash = (hash ^ data[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+// Appends the elements of part to level, with text offsets moved by
+// text_shift and parent indices by parent_shift.
+static void AppendFlatLevel(const TessFlatLevel &part, int text_shift, int parent_shift,
+                            TessFlatLevel *level) {
+  for (size_t i = 0; i < part.size(); ++i) {
+    level->left.push_back(part.left[i]);
+    level->top.push_back(part.top[i]);
+    level->right.push_back(part.right[i]);
+    level->bottom.push_back(part.bottom[i]);
+    level->confidence.push_back(part.confidence[i]);
+    level->text_offset.push_back(part.text_offset[i] + text_shift);
+    level->text_length.push_back(part.text_length[i]);
+    level->parent.push_back(part.parent[i] < 0 ? -1 : part.parent[i] + parent_shift);
+  }
+}
+
+// Appends the result of one strip to the result of a whole frame, as
+// AppendFlatResult would have, starting new blocks.
+static void AppendFlatStrip(const TessFlatResult &part, TessFlatResult *result) {
+  if (part.blocks.size() == 0) {
+    return;
+  }
+  std::string &text = result->text;
+  if (!text.empty()) {
+    text += "\n\n";
+  }
+  int text_shift = text.size();
+  text += part.text;
+  int num_blocks = result->blocks.size();
+  int num_lines = result->lines.size();
+  int num_words = result->words.size();
+  AppendFlatLevel(part.blocks, text_shift, 0, &result->blocks);
+  AppendFlatLevel(part.lines, text_shift, num_blocks, &result->lines);
+  AppendFlatLevel(part.words, text_shift, num_lines, &result->words);
+  AppendFlatLevel(part.symbols, text_shift, num_words, &result->symbols);
+  auto append = [](const std::vector<int> &from, std::vector<int> *to) {
+    to->insert(to->end(), from.begin(), from.end());
+  };
+  append(part.baseline_x1, &result->baseline_x1);
+  append(part.baseline_y1, &result->baseline_y1);
+  append(part.baseline_x2, &result->baseline_x2);
+  append(part.baseline_y2, &result->baseline_y2);
+}
+
+/**
+ * Recognize the image as a frame of a video in strips, reusing the results
+ * of the strips that did not change since the previous frame.
+ */
+bool TessBaseAPI::RecognizeFrame(int strip_height, int overlap, TessFlatResult *result,
+                                 int *recognized_strips) {
+  if (recognized_strips != nullptr) {
+    *recognized_strips = 0;
+  }
+  if (tesseract_ == nullptr || thresholder_ == nullptr || thresholder_->IsEmpty() ||
+      result == nullptr || overlap < 0 || strip_height <= 2 * overlap) {
+    return false;
+  }
+  result->clear();
+  thresholder_->GetImageSizes(&rect_left_, &rect_top_, &rect_width_, &rect_height_,
+                              &image_width_, &image_height_);
+  const int image_width = image_width_;
+  const int image_height = image_height_;
+  thresholder_->SetRectangle(0, 0, image_width, image_height);
+  Image pix = thresholder_->GetPixRect();
+  if (frame_strips_ == nullptr) {
+    frame_strips_ = new FrameStrips;
+  }
+  FrameStrips &frame = *frame_strips_;
+  int depth = pixGetDepth(pix);
+  int resolution = thresholder_->GetSourceYResolution();
+  if (frame.width != image_width || frame.height != image_height || frame.depth != depth ||
+      frame.resolution != resolution || frame.strip_height != strip_height ||
+      frame.overlap != overlap) {
+    ClearFrames();
+    frame.width = image_width;
+    frame.height = image_height;
+    frame.depth = depth;
+    frame.resolution = resolution;
+    frame.strip_height = strip_height;
+    frame.overlap = overlap;
+  }
+  const int step = strip_height - overlap;
+  bool ok = true;
+  int strip = 0;
+  for (int top = 0; top < image_height; top += step, ++strip) {
+    int height = std::min(strip_height, image_height - top);
+    bool last = top + height >= image_height;
+    int owned_top = top == 0 ? 0 : top + overlap / 2;
+    int owned_bottom = last ? image_height : top + step + overlap / 2;
+    uint64_t hash = HashRows(pix, top, height);
+    if (static_cast<size_t>(strip) >= frame.hashes.size()) {
+      frame.hashes.push_back(hash);
+      frame.results.emplace_back();
+    } else if (frame.hashes[strip] == hash) {
+      AppendFlatStrip(frame.results[strip], result);
+      if (last) {
+        break;
+      }
+      continue;
+    }
+    frame.hashes[strip] = hash;
+    TessFlatResult &strip_result = frame.results[strip];
+    strip_result.clear();
+    if (!RecognizeStrip(top, height, owned_top, owned_bottom, &strip_result)) {
+      // Make sure that the failed strip is recognized again next time.
+      frame.hashes.resize(strip);
+      frame.results.resize(strip);
+      ok = false;
+      break;
+    }
+    if (recognized_strips != nullptr) {
+      ++*recognized_strips;
+    }
+    AppendFlatStrip(strip_result, result);
+    if (last) {
+      break;
+    }
+  }
+  pix.destroy();
+  thresholder_->SetRectangle(0, 0, image_width, image_height);
+  ClearResults();
+  return ok;
+}
+
+void TessBaseAPI::ClearFrames() {
+  if (frame_strips_ != nullptr) {
+    *frame_strips_ = FrameStrips();
+  }
+}
+
+// Recognizes one rectangle of RecognizeRegions, using the already clipped
+// images instead of thresholding the rectangle again.
+void TessBaseAPI::RecognizeThresholdedRegion(int left, int top, int width, int height,
+                                             Pix *binary, Pix *grey, Pix *thresholds,
+                                             int resolution, TessRegionResult *result) {
+  thresholder_->SetRectangle(left, top, width, height);
+  ClearResults();
+  thresholder_->GetImageSizes(&rect_left_, &rect_top_, &rect_width_, &rect_height_,
+                              &image_width_, &image_height_);
+  *tesseract_->mutable_pix_binary() = binary;
+  tesseract_->set_pix_grey(grey);
+  tesseract_->set_pix_thresholds(thresholds);
+  tesseract_->set_source_resolution(resolution);
+  result->ok = false;
+  if (Recognize(nullptr) != 0) {
+    return;
+  }
+  char *text = GetUTF8Text();
+  if (text == nullptr) {
+    return;
+  }
+  result->text = text;
+  delete[] text;
+  result->mean_confidence = MeanTextConf();
+  result->ok = true;
+}
+
 // Takes ownership of the input pix.
 void TessBaseAPI::SetInputImage(Pix *pix) {
   tesseract_->set_pix_original(pix);
@@ -870,6 +1365,33 @@ int TessBaseAPI::GetSourceYResolution() {
   return thresholder_->GetSourceYResolution();
 }
 
+// Returns a started pool of engines to recognize the pages of a multipage
+// input concurrently if tessedit_parallel_pages asks for more than one
+// engine, otherwise nullptr. Retrying with another config and the training
+// modes change the state of api from page to page, so they always process
+// the pages one after another.
+static std::unique_ptr<PagePool> StartPagePool(TessBaseAPI *api, const char *retry_config,
+                                               int timeout_millisec,
+                                               TessResultRenderer *renderer) {
+  const Tesseract *tess = api->tesseract();
+  int num_engines = tess->tessedit_parallel_pages;
+  if (num_engines <= 0) {
+    num_engines = std::thread::hardware_concurrency();
+  }
+  if (num_engines <= 1 || (retry_config != nullptr && retry_config[0] != '\0') ||
+      tess->tessedit_resegment_from_boxes || tess->tessedit_resegment_from_line_boxes ||
+      tess->tessedit_train_from_boxes || tess->tessedit_make_boxes_from_boxes ||
+      tess->tessedit_train_line_recognizer || tess->tessedit_ambigs_training) {
+    return nullptr;
+  }
+  auto pool = std::make_unique<PagePool>(renderer, timeout_millisec);
+  if (!pool->Start(api, num_engines)) {
+    tprintf("Warning: Processing the pages one at a time\n");
+    return nullptr;
+  }
+  return pool;
+}
+
 // If flist exists, get data from there. Otherwise get data from buf.
 // Seems convoluted, but is the easiest way I know of to meet multiple
 // goals. Support streaming from stdin, and also work on platforms
@@ -918,6 +1440,11 @@ bool TessBaseAPI::ProcessPagesFileList(FILE *flist, std::string *buf, const char
     return false;
   }
 
+  std::unique_ptr<PagePool> pool;
+  if (tessedit_page_number < 0 && (flist != nullptr || lines.size() > page + 1)) {
+    pool = StartPagePool(this, retry_config, timeout_millisec, renderer);
+  }
+
   // Loop over all pages - or just the requested one
   while (true) {
     if (flist) {
@@ -937,8 +1464,13 @@ bool TessBaseAPI::ProcessPagesFileList(FILE *flist, std::string *buf, const char
       return false;
     }
     tprintf("Page %u : %s\n", page, pagename);
-    bool r = ProcessPage(pix, page, pagename, retry_config, timeout_millisec, renderer);
-    pixDestroy(&pix);
+    bool r;
+    if (pool) {
+      r = pool->AddPage(pix, page, page, pagename);
+    } else {
+      r = ProcessPage(pix, page, pagename, retry_config, timeout_millisec, renderer);
+      pixDestroy(&pix);
+    }
     if (!r) {
       return false;
     }
@@ -947,6 +1479,9 @@ bool TessBaseAPI::ProcessPagesFileList(FILE *flist, std::string *buf, const char
     }
     ++page;
   }
+  if (pool && !pool->Finish()) {
+    return false;
+  }
 
   // Finish producing output
   if (renderer && !renderer->EndDocument()) {
@@ -962,6 +1497,7 @@ bool TessBaseAPI::ProcessPagesMultipageTiff(const l_uint8 *data, size_t size, co
   Pix *pix = nullptr;
   int page = (tessedit_page_number >= 0) ? tessedit_page_number : 0;
   size_t offset = 0;
+  std::unique_ptr<PagePool> pool;
   for (;; ++page) {
     if (tessedit_page_number >= 0) {
       page = tessedit_page_number;
@@ -977,10 +1513,19 @@ bool TessBaseAPI::ProcessPagesMultipageTiff(const l_uint8 *data, size_t size, co
       // Only print page number for multipage TIFF file.
       tprintf("Page %d\n", page + 1);
     }
-    auto page_string = std::to_string(page);
-    SetVariable("applybox_page", page_string.c_str());
-    bool r = ProcessPage(pix, page, filename, retry_config, timeout_millisec, renderer);
-    pixDestroy(&pix);
+    // Only start the engines once it is clear there is more than one page.
+    if (!pool && tessedit_page_number < 0 && offset != 0) {
+      pool = StartPagePool(this, retry_config, timeout_millisec, renderer);
+    }
+    bool r;
+    if (pool) {
+      r = pool->AddPage(pix, page, page + 1, filename);
+    } else {
+      auto page_string = std::to_string(page);
+      SetVariable("applybox_page", page_string.c_str());
+      r = ProcessPage(pix, page, filename, retry_config, timeout_millisec, renderer);
+      pixDestroy(&pix);
+    }
     if (!r) {
       return false;
     }
@@ -991,7 +1536,7 @@ bool TessBaseAPI::ProcessPagesMultipageTiff(const l_uint8 *data, size_t size, co
       break;
     }
   }
-  return true;
+  return !pool || pool->Finish();
 }
 
 // Master ProcessPages calls ProcessPagesInternal and then does any post-
@@ -1336,13 +1881,179 @@ char *TessBaseAPI::GetUTF8Text() {
   return copy_string(text);
 }
 
-static void AddBoxToTSV(const PageIterator *it, PageIteratorLevel level, std::string &text) {
+static void AddBoxToTSV(const RenderBox &box, std::string &text) {
+  text += "\t" + std::to_string(box.left);
+  text += "\t" + std::to_string(box.top);
+  text += "\t" + std::to_string(box.right - box.left);
+  text += "\t" + std::to_string(box.bottom - box.top);
+}
+
+// Appends the box and confidence of the element of res_it at level to flat.
+static void AddFlatElement(const ResultIterator &res_it, PageIteratorLevel level,
+                           int parent, int text_offset, TessFlatLevel *flat) {
   int left, top, right, bottom;
-  it->BoundingBox(level, &left, &top, &right, &bottom);
-  text += "\t" + std::to_string(left);
-  text += "\t" + std::to_string(top);
-  text += "\t" + std::to_string(right - left);
-  text += "\t" + std::to_string(bottom - top);
+  res_it.BoundingBox(level, &left, &top, &right, &bottom);
+  flat->left.push_back(left);
+  flat->top.push_back(top);
+  flat->right.push_back(right);
+  flat->bottom.push_back(bottom);
+  flat->confidence.push_back(res_it.Confidence(level));
+  flat->text_offset.push_back(text_offset);
+  flat->text_length.push_back(0);
+  flat->parent.push_back(parent);
+}
+
+/**
+ * Fill a TessFlatResult from the internal data structures.
+ */
+bool TessBaseAPI::GetFlatResult(TessFlatResult *result) {
+  if (result == nullptr || tesseract_ == nullptr ||
+      (page_res_ == nullptr && Recognize(nullptr) < 0)) {
+    return false;
+  }
+  result->clear();
+  AppendFlatResult(INT_MIN, INT_MAX, result);
+  return true;
+}
+
+void TessBaseAPI::AppendFlatResult(int owned_top, int owned_bottom, TessFlatResult *result) {
+  std::string &text = result->text;
+  // Blocks and lines are only added once they hold an owned word.
+  bool in_block = false;
+  bool in_line = false;
+  const std::unique_ptr</*non-const*/ ResultIterator> res_it(GetIterator());
+  while (!res_it->Empty(RIL_BLOCK)) {
+    if (res_it->Empty(RIL_WORD)) {
+      res_it->Next(RIL_WORD);
+      continue;
+    }
+    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
+      in_block = false;
+    }
+    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
+      in_line = false;
+    }
+    int left, top, right, bottom;
+    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
+    int centre = top + (bottom - top) / 2;
+    if (centre < owned_top || centre >= owned_bottom) {
+      res_it->Next(RIL_WORD);
+      continue;
+    }
+    if (!in_block) {
+      if (!text.empty()) {
+        text += "\n\n";
+      }
+      AddFlatElement(*res_it, RIL_BLOCK, -1, text.size(), &result->blocks);
+      in_block = true;
+      in_line = false;
+    }
+    if (!in_line) {
+      if (!text.empty() && text.back() != '\n') {
+        text += '\n';
+      }
+      AddFlatElement(*res_it, RIL_TEXTLINE, result->blocks.size() - 1, text.size(),
+                     &result->lines);
+      int x1, y1, x2, y2;
+      res_it->Baseline(RIL_TEXTLINE, &x1, &y1, &x2, &y2);
+      result->baseline_x1.push_back(x1);
+      result->baseline_y1.push_back(y1);
+      result->baseline_x2.push_back(x2);
+      result->baseline_y2.push_back(y2);
+      in_line = true;
+    } else {
+      text += ' ';
+    }
+    AddFlatElement(*res_it, RIL_WORD, result->lines.size() - 1, text.size(), &result->words);
+    do {
+      AddFlatElement(*res_it, RIL_SYMBOL, result->words.size() - 1, text.size(),
+                     &result->symbols);
+      res_it->AppendUTF8Text(RIL_SYMBOL, &text);
+      int end = text.size();
+      result->symbols.text_length.back() = end - result->symbols.text_offset.back();
+      result->words.text_length.back() = end - result->words.text_offset.back();
+      result->lines.text_length.back() = end - result->lines.text_offset.back();
+      result->blocks.text_length.back() = end - result->blocks.text_offset.back();
+      res_it->Next(RIL_SYMBOL);
+    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
+  }
+}
+
+bool TessBaseAPI::StartRenderModel() {
+  if (keep_render_model_) {
+    return false;
+  }
+  keep_render_model_ = true;
+  return true;
+}
+
+void TessBaseAPI::EndRenderModel() {
+  keep_render_model_ = false;
+  delete render_model_;
+  render_model_ = nullptr;
+}
+
+// Appends the box of the element of res_it at level to boxes.
+static void AddRenderBox(const ResultIterator &res_it, PageIteratorLevel level,
+                         std::vector<RenderBox> *boxes) {
+  RenderBox box;
+  res_it.BoundingBox(level, &box.left, &box.top, &box.right, &box.bottom);
+  boxes->push_back(box);
+}
+
+/**
+ * Walk the page once and collect what the TSV and ALTO renderers print.
+ */
+const RenderModel *TessBaseAPI::GetRenderModel(ETEXT_DESC *monitor,
+                                                std::unique_ptr<RenderModel> *owner) {
+  if (render_model_ != nullptr) {
+    return render_model_;
+  }
+  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(monitor) < 0)) {
+    return nullptr;
+  }
+  auto model = std::make_unique<RenderModel>();
+  const std::unique_ptr</*non-const*/ ResultIterator> res_it(GetIterator());
+  while (!res_it->Empty(RIL_BLOCK)) {
+    if (res_it->Empty(RIL_WORD)) {
+      res_it->Next(RIL_WORD);
+      continue;
+    }
+    RenderWord word;
+    word.block_type = res_it->BlockType();
+    word.begins_block = res_it->IsAtBeginningOf(RIL_BLOCK);
+    word.begins_para = res_it->IsAtBeginningOf(RIL_PARA);
+    word.begins_line = res_it->IsAtBeginningOf(RIL_TEXTLINE);
+    if (word.begins_block || model->blocks.empty()) {
+      AddRenderBox(*res_it, RIL_BLOCK, &model->blocks);
+    }
+    if (word.begins_para || model->paras.empty()) {
+      AddRenderBox(*res_it, RIL_PARA, &model->paras);
+    }
+    if (word.begins_line || model->lines.empty()) {
+      AddRenderBox(*res_it, RIL_TEXTLINE, &model->lines);
+    }
+    word.ends_line = res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD);
+    word.ends_para = res_it->IsAtFinalElement(RIL_PARA, RIL_WORD);
+    word.ends_block = res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD);
+    word.block = model->blocks.size() - 1;
+    word.para = model->paras.size() - 1;
+    word.line = model->lines.size() - 1;
+    res_it->BoundingBox(RIL_WORD, &word.box.left, &word.box.top, &word.box.right,
+                        &word.box.bottom);
+    word.confidence = res_it->Confidence(RIL_WORD);
+    do {
+      res_it->AppendUTF8Text(RIL_SYMBOL, &word.text);
+      res_it->Next(RIL_SYMBOL);
+    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
+    model->words.push_back(std::move(word));
+  }
+  if (!keep_render_model_) {
+    *owner = std::move(model);
+    return owner->get();
+  }
+  render_model_ = model.release();
+  return render_model_;
 }
 
 /**
@@ -1351,13 +2062,12 @@ static void AddBoxToTSV(const PageIterator *it, PageIteratorLevel level, std::st
  * Returned string must be freed with the delete [] operator.
  */
 char *TessBaseAPI::GetTSVText(int page_number) {
-  if (tesseract_ == nullptr || (page_res_ == nullptr && Recognize(nullptr) < 0)) {
+  std::unique_ptr<RenderModel> model_owner;
+  const RenderModel *model = GetRenderModel(nullptr, &model_owner);
+  if (model == nullptr) {
     return nullptr;
   }
 
-#if !defined(NDEBUG)
-  int lcnt = 1, bcnt = 1, pcnt = 1, wcnt = 1;
-#endif
   int page_id = page_number + 1; // we use 1-based page numbers.
 
   int page_num = page_id;
@@ -1378,15 +2088,9 @@ char *TessBaseAPI::GetTSVText(int page_number) {
   tsv_str += "\t" + std::to_string(rect_height_);
   tsv_str += "\t-1\t\n";
 
-  const std::unique_ptr</*non-const*/ ResultIterator> res_it(GetIterator());
-  while (!res_it->Empty(RIL_BLOCK)) {
-    if (res_it->Empty(RIL_WORD)) {
-      res_it->Next(RIL_WORD);
-      continue;
-    }
-
+  for (const auto &word : model->words) {
     // Add rows for any new block/paragraph/textline.
-    if (res_it->IsAtBeginningOf(RIL_BLOCK)) {
+    if (word.begins_block) {
       block_num++;
       par_num = 0;
       line_num = 0;
@@ -1396,10 +2100,10 @@ char *TessBaseAPI::GetTSVText(int page_number) {
       tsv_str += "\t" + std::to_string(par_num);
       tsv_str += "\t" + std::to_string(line_num);
       tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it.get(), RIL_BLOCK, tsv_str);
+      AddBoxToTSV(model->blocks[word.block], tsv_str);
       tsv_str += "\t-1\t\n"; // end of row for block
     }
-    if (res_it->IsAtBeginningOf(RIL_PARA)) {
+    if (word.begins_para) {
       par_num++;
       line_num = 0;
       word_num = 0;
@@ -1408,10 +2112,10 @@ char *TessBaseAPI::GetTSVText(int page_number) {
       tsv_str += "\t" + std::to_string(par_num);
       tsv_str += "\t" + std::to_string(line_num);
       tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it.get(), RIL_PARA, tsv_str);
+      AddBoxToTSV(model->paras[word.para], tsv_str);
       tsv_str += "\t-1\t\n"; // end of row for para
     }
-    if (res_it->IsAtBeginningOf(RIL_TEXTLINE)) {
+    if (word.begins_line) {
       line_num++;
       word_num = 0;
       tsv_str += "4\t" + std::to_string(page_num); // level 4 - line
@@ -1419,47 +2123,22 @@ char *TessBaseAPI::GetTSVText(int page_number) {
       tsv_str += "\t" + std::to_string(par_num);
       tsv_str += "\t" + std::to_string(line_num);
       tsv_str += "\t" + std::to_string(word_num);
-      AddBoxToTSV(res_it.get(), RIL_TEXTLINE, tsv_str);
+      AddBoxToTSV(model->lines[word.line], tsv_str);
       tsv_str += "\t-1\t\n"; // end of row for line
     }
 
     // Now, process the word...
-    int left, top, right, bottom;
-    res_it->BoundingBox(RIL_WORD, &left, &top, &right, &bottom);
     word_num++;
     tsv_str += "5\t" + std::to_string(page_num); // level 5 - word
     tsv_str += "\t" + std::to_string(block_num);
     tsv_str += "\t" + std::to_string(par_num);
     tsv_str += "\t" + std::to_string(line_num);
     tsv_str += "\t" + std::to_string(word_num);
-    tsv_str += "\t" + std::to_string(left);
-    tsv_str += "\t" + std::to_string(top);
-    tsv_str += "\t" + std::to_string(right - left);
-    tsv_str += "\t" + std::to_string(bottom - top);
-    tsv_str += "\t" + std::to_string(res_it->Confidence(RIL_WORD));
+    AddBoxToTSV(word.box, tsv_str);
+    tsv_str += "\t" + std::to_string(word.confidence);
     tsv_str += "\t";
-
-#if !defined(NDEBUG)
-    // Increment counts if at end of block/paragraph/textline.
-    if (res_it->IsAtFinalElement(RIL_TEXTLINE, RIL_WORD)) {
-      lcnt++;
-    }
-    if (res_it->IsAtFinalElement(RIL_PARA, RIL_WORD)) {
-      pcnt++;
-    }
-    if (res_it->IsAtFinalElement(RIL_BLOCK, RIL_WORD)) {
-      bcnt++;
-    }
-#endif
-
-    do {
-      tsv_str += std::unique_ptr<const char[]>(res_it->GetUTF8Text(RIL_SYMBOL)).get();
-      res_it->Next(RIL_SYMBOL);
-    } while (!res_it->Empty(RIL_BLOCK) && !res_it->IsAtBeginningOf(RIL_WORD));
+    tsv_str += word.text;
     tsv_str += "\n"; // end of row
-#if !defined(NDEBUG)
-    wcnt++;
-#endif
   }
 
   return copy_string(tsv_str);
@@ -1884,6 +2563,8 @@ void TessBaseAPI::End() {
 #endif // ndef DISABLED_LEGACY_ENGINE
   delete tesseract_;
   tesseract_ = nullptr;
+  delete frame_strips_;
+  frame_strips_ = nullptr;
   input_file_.clear();
   output_file_.clear();
   datapath_.clear();
@@ -1897,6 +2578,9 @@ void TessBaseAPI::End() {
 // of these caches.
 void TessBaseAPI::ClearPersistentCache() {
   Dict::GlobalDawgCache()->DeleteUnusedDawgs();
+#ifndef DISABLED_LEGACY_ENGINE
+  Classify::GlobalTemplateCache()->DeleteUnusedTemplates();
+#endif // ndef DISABLED_LEGACY_ENGINE
 }
 
 /**
@@ -2150,6 +2834,27 @@ float TessBaseAPI::GetGradient() {
   return tesseract_->gradient();
 }
 
+/** Estimate the skew of the text lines without layout analysis. */
+bool TessBaseAPI::EstimateSkew(float *angle, float *confidence, bool *vertical) {
+  if (tesseract_ == nullptr || thresholder_ == nullptr || thresholder_->IsEmpty()) {
+    return false;
+  }
+  if (tesseract_->pix_binary() == nullptr && !Threshold(&tesseract_->mutable_pix_binary()->pix_)) {
+    return false;
+  }
+  float gradient;
+  bool is_vertical;
+  if (!FindTextSkew(tesseract_->pix_binary(), tesseract_->source_resolution(), &gradient,
+                    confidence, &is_vertical)) {
+    return false;
+  }
+  *angle = std::atan(gradient) * 180.0 / M_PI;
+  if (vertical != nullptr) {
+    *vertical = is_vertical;
+  }
+  return true;
+}
+
 /** Delete the pageres and clear the block list ready for a new page. */
 void TessBaseAPI::ClearResults() {
   if (tesseract_ != nullptr) {
@@ -2158,6 +2863,8 @@ void TessBaseAPI::ClearResults() {
   delete page_res_;
   page_res_ = nullptr;
   recognition_done_ = false;
+  delete render_model_;
+  render_model_ = nullptr;
   if (block_list_ == nullptr) {
     block_list_ = new BLOCK_LIST;
   } else {
@@ -15,6 +15,7 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+#include <tesseract/asyncapi.h>
 #include <tesseract/capi.h>
 
 const char *TessVersion() {
@@ -304,6 +305,15 @@ char *TessBaseAPIRect(TessBaseAPI *handle, const unsigned char *imagedata, int b
 void TessBaseAPIClearAdaptiveClassifier(TessBaseAPI *handle) {
   handle->ClearAdaptiveClassifier();
 }
+
+BOOL TessBaseAPISaveAdaptedTemplates(TessBaseAPI *handle, const char *document_class) {
+  return static_cast<int>(handle->SaveAdaptedTemplates(document_class));
+}
+
+BOOL TessBaseAPILoadAdaptedTemplates(TessBaseAPI *handle, const char *document_class,
+                                     BOOL merge) {
+  return static_cast<int>(handle->LoadAdaptedTemplates(document_class, merge != 0));
+}
 #endif
 
 void TessBaseAPISetImage(TessBaseAPI *handle, const unsigned char *imagedata, int width, int height,
@@ -315,6 +325,10 @@ void TessBaseAPISetImage2(TessBaseAPI *handle, struct Pix *pix) {
   return handle->SetImage(pix);
 }
 
+void TessBaseAPISetImageBorrowed(TessBaseAPI *handle, struct Pix *pix) {
+  handle->SetImageBorrowed(pix);
+}
+
 void TessBaseAPISetSourceResolution(TessBaseAPI *handle, int ppi) {
   handle->SetSourceResolution(ppi);
 }
@@ -331,6 +345,16 @@ float TessBaseAPIGetGradient(TessBaseAPI *handle) {
   return handle->GetGradient();
 }
 
+BOOL TessBaseAPIEstimateSkew(TessBaseAPI *handle, float *angle, float *confidence,
+                             BOOL *vertical) {
+  bool is_vertical = false;
+  bool success = handle->EstimateSkew(angle, confidence, &is_vertical);
+  if (success && vertical != nullptr) {
+    *vertical = static_cast<int>(is_vertical);
+  }
+  return static_cast<int>(success);
+}
+
 void TessBaseAPIClearPersistentCache(TessBaseAPI * /*handle*/) {
   TessBaseAPI::ClearPersistentCache();
 }
@@ -396,6 +420,10 @@ int TessBaseAPIRecognize(TessBaseAPI *handle, ETEXT_DESC *monitor) {
   return handle->Recognize(monitor);
 }
 
+int TessBaseAPIGetDegradations(const TessBaseAPI *handle) {
+  return handle->GetDegradations();
+}
+
 BOOL TessBaseAPIProcessPages(TessBaseAPI *handle, const char *filename, const char *retry_config,
                              int timeout_millisec, TessResultRenderer *renderer) {
   return static_cast<int>(handle->ProcessPages(filename, retry_config, timeout_millisec, renderer));
@@ -503,6 +531,98 @@ void TessBaseGetBlockTextOrientations(TessBaseAPI *handle, int **block_orientati
   handle->GetBlockTextOrientations(block_orientation, vertical_writing);
 }
 
+TessAsyncAPI *TessAsyncAPICreate(const TessBaseAPI *handle, int num_workers, int max_pending) {
+  auto *async_api = new TessAsyncAPI;
+  if (!async_api->Start(*handle, num_workers, max_pending)) {
+    delete async_api;
+    return nullptr;
+  }
+  return async_api;
+}
+
+void TessAsyncAPIDelete(TessAsyncAPI *handle) {
+  delete handle;
+}
+
+BOOL TessAsyncAPISubmit(TessAsyncAPI *handle, struct Pix *pix, TessAsyncCallback callback,
+                        void *user_data) {
+  return static_cast<int>(handle->Submit(pix, [callback, user_data](TessBaseAPI *api, bool ok) {
+    if (callback != nullptr) {
+      callback(api, static_cast<int>(ok), user_data);
+    }
+  }));
+}
+
+void TessAsyncAPIWait(TessAsyncAPI *handle) {
+  handle->Wait();
+}
+
+TessFlatResult *TessFlatResultCreate() {
+  return new TessFlatResult;
+}
+
+void TessFlatResultDelete(TessFlatResult *result) {
+  delete result;
+}
+
+BOOL TessBaseAPIGetFlatResult(TessBaseAPI *handle, TessFlatResult *result) {
+  return static_cast<int>(handle->GetFlatResult(result));
+}
+
+const char *TessFlatResultText(const TessFlatResult *result, int *length) {
+  *length = result->text.size();
+  return result->text.data();
+}
+
+template <typename T>
+static void SetArray(const std::vector<T> &values, const T **array) {
+  if (array != nullptr) {
+    *array = values.data();
+  }
+}
+
+int TessFlatResultLevel(const TessFlatResult *result, TessPageIteratorLevel level,
+                        const int **left, const int **top, const int **right,
+                        const int **bottom, const float **confidence,
+                        const int **text_offset, const int **text_length,
+                        const int **parent) {
+  const tesseract::TessFlatLevel *flat;
+  switch (level) {
+    case tesseract::RIL_BLOCK:
+      flat = &result->blocks;
+      break;
+    case tesseract::RIL_TEXTLINE:
+      flat = &result->lines;
+      break;
+    case tesseract::RIL_WORD:
+      flat = &result->words;
+      break;
+    case tesseract::RIL_SYMBOL:
+      flat = &result->symbols;
+      break;
+    default:
+      return 0;
+  }
+  SetArray(flat->left, left);
+  SetArray(flat->top, top);
+  SetArray(flat->right, right);
+  SetArray(flat->bottom, bottom);
+  SetArray(flat->confidence, confidence);
+  SetArray(flat->text_offset, text_offset);
+  SetArray(flat->text_length, text_length);
+  SetArray(flat->parent, parent);
+  return flat->size();
+}
+
+int TessFlatResultBaselines(const TessFlatResult *result, const int **x1, const int **y1,
+                            const int **x2, const int **y2) {
+  SetArray(result->baseline_x1, x1);
+  SetArray(result->baseline_y1, y1);
+  SetArray(result->baseline_x2, x2);
+  SetArray(result->baseline_y2, y2);
+  return result->baseline_x1.size();
+}
+
 void TessPageIteratorDelete(TessPageIterator *handle) {
   delete handle;
 }
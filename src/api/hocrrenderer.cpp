@@ -20,9 +20,11 @@
 #include <tesseract/baseapi.h> // for TessBaseAPI
 #include <locale>              // for std::locale::classic
 #include <memory>              // for std::unique_ptr
+#include <ostream>             // for std::ostream
 #include <sstream>             // for std::stringstream
 #include <tesseract/renderer.h>
 #include "helpers.h"        // for copy_string
+#include "renderbuf.h"      // for RenderBuf
 #include "tesseractclass.h" // for Tesseract
 
 namespace tesseract {
@@ -50,7 +52,7 @@ static tesseract::Orientation GetBlockTextOrientation(const PageIterator *it) {
  */
 static void AddBaselineCoordsTohOCR(const PageIterator *it,
                                     PageIteratorLevel level,
-                                    std::stringstream &hocr_str) {
+                                    std::ostream &hocr_str) {
   tesseract::Orientation orientation = GetBlockTextOrientation(it);
   if (orientation != ORIENTATION_PAGE_UP) {
     hocr_str << "; textangle " << 360 - orientation * 90;
@@ -87,7 +89,7 @@ static void AddBaselineCoordsTohOCR(const PageIterator *it,
 }
 
 static void AddBoxTohOCR(const ResultIterator *it, PageIteratorLevel level,
-                         std::stringstream &hocr_str) {
+                         std::ostream &hocr_str) {
   int left, top, right, bottom;
   it->BoundingBox(level, &left, &top, &right, &bottom);
   // This is the only place we use double quotes instead of single quotes,
@@ -130,9 +132,22 @@ char *TessBaseAPI::GetHOCRText(int page_number) {
  * Returned string must be freed with the delete [] operator.
  */
 char *TessBaseAPI::GetHOCRText(ETEXT_DESC *monitor, int page_number) {
+  std::stringstream hocr_str;
+  if (!WriteHOCRText(hocr_str, monitor, page_number)) {
+    return nullptr;
+  }
+  return copy_string(hocr_str.str());
+}
+
+/**
+ * Write the hOCR markup of the page to hocr_str while walking the
+ * internal data structures.
+ */
+bool TessBaseAPI::WriteHOCRText(std::ostream &hocr_str, ETEXT_DESC *monitor,
+                                int page_number) {
   if (tesseract_ == nullptr ||
       (page_res_ == nullptr && Recognize(monitor) < 0)) {
-    return nullptr;
+    return false;
   }
 
   int lcnt = 1, bcnt = 1, pcnt = 1, wcnt = 1, scnt = 1, tcnt = 1, ccnt = 1;
@@ -148,11 +163,10 @@ char *TessBaseAPI::GetHOCRText(ETEXT_DESC *monitor, int page_number) {
     SetInputName(nullptr);
   }
 
-  std::stringstream hocr_str;
   // Use "C" locale (needed for double values x_size and x_descenders).
-  hocr_str.imbue(std::locale::classic());
+  const std::locale locale = hocr_str.imbue(std::locale::classic());
   // Use 8 digits for double values.
-  hocr_str.precision(8);
+  const std::streamsize precision = hocr_str.precision(8);
   hocr_str << "  <div class='ocr_page'"
            << " id='"
            << "page_" << page_id << "'"
@@ -460,8 +474,9 @@ char *TessBaseAPI::GetHOCRText(ETEXT_DESC *monitor, int page_number) {
     }
   }
   hocr_str << "  </div>\n";
-
-  return copy_string(hocr_str.str());
+  hocr_str.imbue(locale);
+  hocr_str.precision(precision);
+  return true;
 }
 
 /**********************************************************************
@@ -511,14 +526,9 @@ bool TessHOcrRenderer::EndDocumentHandler() {
 }
 
 bool TessHOcrRenderer::AddImageHandler(TessBaseAPI *api) {
-  const std::unique_ptr<const char[]> hocr(api->GetHOCRText(imagenum()));
-  if (hocr == nullptr) {
-    return false;
-  }
-
-  AppendString(hocr.get());
-
-  return true;
+  RenderBuf buffer([this](const char *data, int length) { AppendData(data, length); });
+  std::ostream hocr_str(&buffer);
+  return api->WriteHOCRText(hocr_str, nullptr, imagenum());
 }
 
 } // namespace tesseract
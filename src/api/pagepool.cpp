@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagepool.cpp
+// Description: Recognizes the pages of a document on a pool of engines.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagepool.h"
+
+#include "tprintf.h" // for tprintf
+
+#include <allheaders.h> // for pixDestroy
+#include <tesseract/baseapi.h>
+#include <tesseract/renderer.h>
+
+#include <chrono> // for std::chrono
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+namespace tesseract {
+
+bool PagePool::Start(TessBaseAPI *api, int num_engines) {
+  std::vector<TessBaseAPI *> engines(1, api);
+  for (int i = 1; i < num_engines; ++i) {
+    auto clone = std::make_unique<TessBaseAPI>();
+    if (clone->InitFrom(*api) != 0) {
+      tprintf("Error: Could not initialize engine %d for parallel pages\n", i);
+      clones_.clear();
+      return false;
+    }
+    engines.push_back(clone.get());
+    clones_.push_back(std::move(clone));
+  }
+  for (auto *engine : engines) {
+    threads_.emplace_back(&PagePool::EngineLoop, this, engine);
+  }
+  return true;
+}
+
+bool PagePool::AddPage(Pix *pix, int page_index, int page_number, const char *filename) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_changed_.wait(lock, [this] { return queue_.size() < threads_.size() || failed_; });
+  if (failed_) {
+    lock.unlock();
+    pixDestroy(&pix);
+    return false;
+  }
+  queue_.push_back({pix, page_index, page_number, filename, num_pages_++});
+  queue_changed_.notify_all();
+  return true;
+}
+
+bool PagePool::Finish() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finishing_ = true;
+  }
+  queue_changed_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  clones_.clear();
+  return !failed_;
+}
+
+void PagePool::EngineLoop(TessBaseAPI *api) {
+#ifdef _OPENMP
+  // The pages already keep the cores busy, so the parallel regions that
+  // size themselves from omp_get_max_threads, such as binarization, stay on
+  // this thread instead of starting a team per engine.
+  omp_set_num_threads(1);
+#endif
+  for (;;) {
+    Page page;
+    bool skip;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_changed_.wait(lock, [this] { return !queue_.empty() || finishing_; });
+      if (queue_.empty()) {
+        return;
+      }
+      page = std::move(queue_.front());
+      queue_.pop_front();
+      skip = failed_;
+    }
+    queue_changed_.notify_all();
+    auto start_time = std::chrono::steady_clock::now();
+    bool ok = !skip && api->ProcessPage(page.pix, page.page_index, page.filename.c_str(),
+                                        nullptr, timeout_millisec_, nullptr);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start_time;
+    pixDestroy(&page.pix);
+    {
+      // Wait for the turn of this page, so pages are rendered in order and
+      // a failed page stops all the pages that follow it.
+      std::unique_lock<std::mutex> lock(mutex_);
+      page_rendered_.wait(lock, [this, &page] { return next_to_render_ == page.sequence; });
+      skip = skip || failed_;
+      ok = ok && !failed_;
+    }
+    if (ok && renderer_ != nullptr) {
+      ok = renderer_->AddImage(api);
+    }
+    if (!skip) {
+      // Report in page order and numbering, as the sequential loop does.
+      tprintf("Page %d : %s %s in %.3f s\n", page.page_number, page.filename.c_str(),
+              ok ? "done" : "failed", seconds.count());
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      failed_ = failed_ || !ok;
+      ++next_to_render_;
+    }
+    page_rendered_.notify_all();
+    queue_changed_.notify_all();
+  }
+}
+
+} // namespace tesseract
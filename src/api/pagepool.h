@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagepool.h
+// Description: Recognizes the pages of a document on a pool of engines.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_PAGEPOOL_H_
+#define TESSERACT_API_PAGEPOOL_H_
+
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <memory>             // for std::unique_ptr
+#include <mutex>              // for std::mutex
+#include <string>             // for std::string
+#include <thread>             // for std::thread
+#include <vector>             // for std::vector
+
+struct Pix;
+
+namespace tesseract {
+
+class TessBaseAPI;
+class TessResultRenderer;
+
+// Recognizes the pages of a document concurrently, each page on one of a
+// pool of engines, and passes the results to the renderer strictly in the
+// order the pages were added. An engine that finishes a page early keeps
+// its results until it is the page's turn to be rendered, so at most one
+// page per engine is waiting, plus one page per engine queued for input.
+class PagePool {
+public:
+  PagePool(TessResultRenderer *renderer, int timeout_millisec)
+      : renderer_(renderer), timeout_millisec_(timeout_millisec) {}
+  ~PagePool() {
+    Finish();
+  }
+  PagePool(const PagePool &) = delete;
+  PagePool &operator=(const PagePool &) = delete;
+
+  // Starts num_engines engines: api itself, which must stay alive and
+  // unused until Finish, and num_engines - 1 engines initialized from it.
+  // Returns false if an engine could not be initialized.
+  bool Start(TessBaseAPI *api, int num_engines);
+
+  // Queues the page for recognition, taking ownership of pix. Waits while
+  // the queue is full. Returns false if an earlier page has failed, in which
+  // case the page is dropped. page_number is the number that the sequential
+  // loop of the caller prints for the page.
+  bool AddPage(Pix *pix, int page_index, int page_number, const char *filename);
+
+  // Waits until all queued pages have been rendered and stops the engines.
+  // Returns false if any page failed.
+  bool Finish();
+
+private:
+  struct Page {
+    Pix *pix;
+    int page_index;
+    int page_number;
+    std::string filename;
+    // Position in the order in which pages are rendered.
+    unsigned sequence;
+  };
+
+  // Runs in a thread per engine until Finish is called and the queue is
+  // empty.
+  void EngineLoop(TessBaseAPI *api);
+
+  TessResultRenderer *renderer_;
+  int timeout_millisec_;
+  // The engines other than the one passed to Start.
+  std::vector<std::unique_ptr<TessBaseAPI>> clones_;
+  std::vector<std::thread> threads_;
+
+  // Everything below is guarded by mutex_.
+  std::mutex mutex_;
+  // Signalled when a page is added or taken, and by Finish.
+  std::condition_variable queue_changed_;
+  // Signalled when a page has been rendered.
+  std::condition_variable page_rendered_;
+  std::deque<Page> queue_;
+  unsigned num_pages_ = 0;
+  unsigned next_to_render_ = 0;
+  bool finishing_ = false;
+  bool failed_ = false;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_API_PAGEPOOL_H_
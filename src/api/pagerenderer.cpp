@@ -13,10 +13,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include "errcode.h" // for ASSERT_HOST
-#include "helpers.h" // for copy_string
-#include "image.h"   // for Leptonica (ptaGetCount, ...)
-#include "tprintf.h" // for tprintf
+#include "errcode.h"   // for ASSERT_HOST
+#include "helpers.h"   // for copy_string
+#include "image.h"     // for Leptonica (ptaGetCount, ...)
+#include "renderbuf.h" // for RenderBuf
+#include "tprintf.h"   // for tprintf
 
 #include <tesseract/baseapi.h>
 #include <tesseract/renderer.h>
@@ -24,6 +25,7 @@
 #include <ctime>
 #include <iomanip>
 #include <memory>
+#include <ostream> // for std::ostream
 #include <regex>
 #include <sstream> // for std::stringstream
 #include <unordered_set>
@@ -672,14 +674,9 @@ bool TessPAGERenderer::AddImageHandler(TessBaseAPI *api) {
     begin_document = false;
   }
 
-  const std::unique_ptr<const char[]> text(api->GetPAGEText(imagenum()));
-  if (text == nullptr) {
-    return false;
-  }
-
-  AppendString(text.get());
-
-  return true;
+  RenderBuf buffer([this](const char *data, int length) { AppendData(data, length); });
+  std::ostream page_str(&buffer);
+  return api->WritePAGEText(page_str, nullptr, imagenum());
 }
 
 ///
@@ -705,10 +702,23 @@ char *TessBaseAPI::GetPAGEText(int page_number) {
 /// Make an XML-formatted string with PAGE markup from the internal
 /// data structures.
 ///
-char *TessBaseAPI::GetPAGEText(ETEXT_DESC *monitor, int /*page_number*/) {
+char *TessBaseAPI::GetPAGEText(ETEXT_DESC *monitor, int page_number) {
+  std::stringstream page_str;
+  if (!WritePAGEText(page_str, monitor, page_number)) {
+    return nullptr;
+  }
+  return copy_string(page_str.str());
+}
+
+///
+/// Write the PAGE markup of the page to out from the internal data
+/// structures.
+///
+bool TessBaseAPI::WritePAGEText(std::ostream &out, ETEXT_DESC *monitor,
+                                int /*page_number*/) {
   if (tesseract_ == nullptr ||
       (page_res_ == nullptr && Recognize(monitor) < 0)) {
-    return nullptr;
+    return false;
   }
 
   int rcnt = 0, lcnt = 0, wcnt = 0;
@@ -1127,13 +1137,15 @@ char *TessBaseAPI::GetPAGEText(ETEXT_DESC *monitor, int /*page_number*/) {
   reading_order_str << "\t\t\t</OrderedGroup>\n"
                     << "\t\t</ReadingOrder>\n";
 
-  reading_order_str << page_str.str();
-  page_str.str("");
-  reading_order_str << "\t</Page>\n";
-  const std::string &text = reading_order_str.str();
-  reading_order_str.str("");
-
-  return copy_string(text);
+  // The regions can only follow the complete reading order, so copy both
+  // buffers to the output without joining them first. Inserting an empty
+  // buffer would set failbit, so a page without regions skips its buffer.
+  out << reading_order_str.rdbuf();
+  if (page_str.tellp() > 0) {
+    out << page_str.rdbuf();
+  }
+  out << "\t</Page>\n";
+  return true;
 }
 
 } // namespace tesseract
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////
+// File:        renderbuf.h
+// Description: Stream buffer that passes renderer output on in chunks.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_RENDERBUF_H_
+#define TESSERACT_API_RENDERBUF_H_
+
+#include <functional> // for std::function
+#include <streambuf>  // for std::streambuf
+#include <utility>    // for std::move
+#include <vector>     // for std::vector
+
+namespace tesseract {
+
+// Collects what is written to it in a fixed size buffer and hands it to
+// sink whenever the buffer is full, on flush and on destruction. Lets the
+// renderers write markup straight to their output while they walk a page,
+// instead of building the whole page as a string first.
+class RenderBuf : public std::streambuf {
+public:
+  using Sink = std::function<void(const char *data, int length)>;
+
+  explicit RenderBuf(Sink sink, int size = kDefaultSize)
+      : sink_(std::move(sink)), buffer_(size) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+  ~RenderBuf() override {
+    Flush();
+  }
+
+protected:
+  int_type overflow(int_type c) override {
+    Flush();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+  int sync() override {
+    Flush();
+    return 0;
+  }
+
+private:
+  static const int kDefaultSize = 64 * 1024;
+
+  // Passes the buffered data to the sink and empties the buffer.
+  void Flush() {
+    int length = pptr() - pbase();
+    if (length > 0) {
+      sink_(pbase(), length);
+    }
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  Sink sink_;
+  std::vector<char> buffer_;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_API_RENDERBUF_H_
@@ -90,10 +90,15 @@ bool TessResultRenderer::AddImage(TessBaseAPI *api) {
     return false;
   }
   ++imagenum_;
+  // The first renderer of a chain lets all of them share one render model.
+  bool owns_model = api->StartRenderModel();
   bool ok = AddImageHandler(api);
   if (next_) {
     ok = next_->AddImage(api) && ok;
   }
+  if (owns_model) {
+    api->EndRenderModel();
+  }
   return ok;
 }
 
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////
+// File:        rendermodel.h
+// Description: Per-page results shared by the output renderers.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_RENDERMODEL_H_
+#define TESSERACT_API_RENDERMODEL_H_
+
+#include <tesseract/publictypes.h> // for PolyBlockType
+
+#include <string> // for std::string
+#include <vector> // for std::vector
+
+namespace tesseract {
+
+// A bounding box in image coordinates, as returned by BoundingBox.
+struct RenderBox {
+  int left;
+  int top;
+  int right;
+  int bottom;
+};
+
+// One word position of a ResultIterator walk over the page, with what
+// the renderers print about it and the elements it starts or ends.
+struct RenderWord {
+  PolyBlockType block_type;
+  // IsAtBeginningOf for the block, paragraph and text line.
+  bool begins_block;
+  bool begins_para;
+  bool begins_line;
+  // IsAtFinalElement of the text line, paragraph and block.
+  bool ends_line;
+  bool ends_para;
+  bool ends_block;
+  // Indices of the enclosing elements in RenderModel.
+  int block;
+  int para;
+  int line;
+  RenderBox box;
+  float confidence;
+  // The text of all symbols of the word, as given by GetUTF8Text(RIL_SYMBOL).
+  std::string text;
+};
+
+// The results of one page, walked once with a ResultIterator and then
+// shared by all renderers of a chain instead of each walking the page
+// again. Built by TessBaseAPI::GetRenderModel.
+struct RenderModel {
+  std::vector<RenderBox> blocks;
+  std::vector<RenderBox> paras;
+  std::vector<RenderBox> lines;
+  std::vector<RenderWord> words;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_API_RENDERMODEL_H_
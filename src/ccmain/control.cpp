@@ -54,6 +54,19 @@ const double kMinRefitXHeightFraction = 0.5;
 
 namespace tesseract {
 
+// Min number of words of pass 1 done to project its use of the time budget.
+const int kMinBudgetWords = 3;
+// Projected use of the time budget by the end of pass 1 above which the
+// dictionary is dropped as well as the inverted retries.
+const double kMaxProjectedBudget = 1.5;
+// Projected use of the time budget by the end of pass 1 above which the
+// LSTM beam is narrowed as well.
+const double kMaxProjectedBudgetForFullBeam = 2.0;
+#ifndef DISABLED_LEGACY_ENGINE
+// Min fraction of the time budget left after pass 1 to run the later passes.
+const double kMinBudgetForLaterPasses = 0.5;
+#endif // ndef DISABLED_LEGACY_ENGINE
+
 /**
  * Make a word from the selected blobs and run Tess on them.
  *
@@ -196,6 +209,31 @@ void Tesseract::SetupWordPassN(int pass_n, WordData *word) {
   }
 }
 
+// Returns the RecognitionDegradation flags to recognize the rest of pass 1
+// with, after words_done of num_words, given that the fraction used of the
+// time budget is now used, and was budget_start when the pass started. The
+// inverted retries are dropped once the pass is projected to overrun the
+// budget, the dictionary too once it is projected to overrun it by far, and
+// the LSTM beam is narrowed once it is projected to overrun it by even more
+// or it has run out.
+static int BudgetDegradations(double used, double budget_start, int words_done,
+                              int num_words) {
+  if (used >= 1.0) {
+    return DEGRADE_NO_INVERT | DEGRADE_NO_DICT | DEGRADE_NARROW_BEAM;
+  }
+  if (words_done < kMinBudgetWords) {
+    return 0;
+  }
+  double projected = budget_start + (used - budget_start) * num_words / words_done;
+  if (projected > kMaxProjectedBudgetForFullBeam) {
+    return DEGRADE_NO_INVERT | DEGRADE_NO_DICT | DEGRADE_NARROW_BEAM;
+  }
+  if (projected > kMaxProjectedBudget) {
+    return DEGRADE_NO_INVERT | DEGRADE_NO_DICT;
+  }
+  return projected > 1.0 ? DEGRADE_NO_INVERT : 0;
+}
+
 // Runs word recognition on all the words.
 bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT *pr_it,
                                    std::vector<WordData> *words) {
@@ -205,6 +243,9 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
   // added. The results will be significantly different with adaption on, and
   // deterioration will need investigation.
   pr_it->restart_page();
+  // The time budget used by layout analysis is not for pass 1 to make up.
+  bool has_budget = pass_n == 1 && tessedit_time_budget_msecs > 0;
+  double budget_start = has_budget ? TimeBudgetUsed() : 0.0;
   for (unsigned w = 0; w < words->size(); ++w) {
     WordData *word = &(*words)[w];
     if (w > 0) {
@@ -230,6 +271,13 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
         return false;
       }
     }
+    if (has_budget) {
+      int degradations =
+          degradations_ | BudgetDegradations(TimeBudgetUsed(), budget_start, w, words->size());
+      if (degradations != degradations_) {
+        SetDegradations(degradations);
+      }
+    }
     if (word->word->tess_failed) {
       unsigned s;
       for (s = 0; s < word->lang_words.size() && word->lang_words[s]->tess_failed; ++s) {
@@ -267,6 +315,26 @@ bool Tesseract::RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT
   return true;
 }
 
+void Tesseract::SetDegradations(int degradations) {
+  degradations_ = degradations;
+  for (auto &lang : sub_langs_) {
+    lang->degradations_ = degradations;
+  }
+}
+
+void Tesseract::StartTimeBudget() {
+  budget_start_ = std::chrono::steady_clock::now();
+  SetDegradations(0);
+}
+
+double Tesseract::TimeBudgetUsed() const {
+  if (tessedit_time_budget_msecs <= 0) {
+    return 0.0;
+  }
+  std::chrono::duration<double, std::milli> used = std::chrono::steady_clock::now() - budget_start_;
+  return used.count() / tessedit_time_budget_msecs;
+}
+
 /**
  * recog_all_words()
  *
@@ -343,10 +411,24 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
     stats_.doc_good_char_quality = 0;
 
     most_recently_used_ = this;
+    if (lstm_recognizer_ != nullptr) {
+      lstm_recognizer_->ResetPolarityCounts();
+    }
+    for (auto &lang : sub_langs_) {
+      if (lang->lstm_recognizer_ != nullptr) {
+        lang->lstm_recognizer_->ResetPolarityCounts();
+      }
+    }
     // Run pass 1 word recognition.
     if (!RecogAllWordsPassN(1, monitor, &page_res_it, &words)) {
       return false;
     }
+    if (tessedit_timing_debug) {
+      ReportPolarityCounts();
+      for (auto &lang : sub_langs_) {
+        lang->ReportPolarityCounts();
+      }
+    }
     // Pass 1 post-processing.
     for (page_res_it.restart_page(); page_res_it.word() != nullptr; page_res_it.forward()) {
       if (page_res_it.word()->word->flag(W_REP_CHAR)) {
@@ -374,8 +456,17 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
 
 #ifndef DISABLED_LEGACY_ENGINE
 
+  // The passes after pass 1 are only run for the legacy engine, so they are
+  // the first to go when the time budget runs short.
+  if (tessedit_time_budget_msecs > 0 && AnyTessLang() &&
+      TimeBudgetUsed() > 1.0 - kMinBudgetForLaterPasses) {
+    SetDegradations(degradations_ | DEGRADE_NO_LATER_PASSES);
+  }
+  bool later_passes = (degradations_ & DEGRADE_NO_LATER_PASSES) == 0;
+
   // ****************** Pass 2 *******************
-  if (tessedit_tess_adaption_mode != 0x0 && !tessedit_test_adaption && AnyTessLang()) {
+  if (later_passes && tessedit_tess_adaption_mode != 0x0 && !tessedit_test_adaption &&
+      AnyTessLang()) {
     page_res_it.restart_page();
     std::vector<WordData> words;
     SetupAllWordsPassN(2, target_word_box, word_config, page_res, &words);
@@ -390,7 +481,7 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
   }
 
   // The next passes are only required for Tess-only.
-  if (AnyTessLang() && !AnyLSTMLang()) {
+  if (later_passes && AnyTessLang() && !AnyLSTMLang()) {
     // ****************** Pass 3 *******************
     // Fix fuzzy spaces.
 
@@ -455,6 +546,19 @@ bool Tesseract::recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor,
   return true;
 }
 
+// Prints how the polarity of the lines of the page was decided: predicted
+// from the line image, or by recognizing the line normal and inverted.
+void Tesseract::ReportPolarityCounts() const {
+  if (lstm_recognizer_ == nullptr) {
+    return;
+  }
+  const PolarityCounts &counts = lstm_recognizer_->polarity_counts();
+  tprintf("Line polarity (%s): %d normal, %d inverted, %d ambiguous;"
+          " %d recognized both ways, %d of them inverted\n",
+          lang.c_str(), counts.normal, counts.inverted, counts.ambiguous, counts.both_ways,
+          counts.both_ways_inverted);
+}
+
 #ifndef DISABLED_LEGACY_ENGINE
 
 void Tesseract::bigram_correction_pass(PAGE_RES *page_res) {
@@ -24,7 +24,10 @@
 #include "recodebeam.h"
 #include "tprintf.h"
 
+#include <tesseract/publictypes.h> // for DEGRADE_NO_DICT, ...
+
 #include <algorithm>
+#include <cfloat> // for FLT_MAX
 
 namespace tesseract {
 
@@ -248,8 +251,11 @@ void Tesseract::LSTMRecognizeWord(const BLOCK &block, ROW *row, WERD_RES *word,
     return;
   }
 
-  bool do_invert = tessedit_do_invert;
+  bool do_invert = tessedit_do_invert && (degradations_ & DEGRADE_NO_INVERT) == 0;
   float threshold = do_invert ? double(invert_threshold) : 0.0f;
+  lstm_recognizer_->SetUseDict((degradations_ & DEGRADE_NO_DICT) == 0);
+  lstm_recognizer_->SetNarrowBeam((degradations_ & DEGRADE_NARROW_BEAM) != 0);
+  lstm_recognizer_->SetPredictPolarity(lstm_predict_polarity);
   lstm_recognizer_->RecognizeLine(*im_data, threshold, classify_debug_level > 0,
                                   kWorstDictCertainty / kCertaintyScale, word_box, words,
                                   lstm_choice_mode, lstm_choice_iterations);
@@ -257,6 +263,82 @@ void Tesseract::LSTMRecognizeWord(const BLOCK &block, ROW *row, WERD_RES *word,
   SearchWords(words);
 }
 
+// Recognizes the whole of pix as a single text line with the LSTM
+// recognizer of each language that has one, without thresholding or layout
+// analysis, converting the words of the language with the best mean
+// certainty to WERD_RES in *words. Boxes are in the coordinates of pix, with
+// the origin at the bottom-left, and blob boxes come from the network output
+// positions.
+// Returns false if there is no LSTM recognizer or no usable image.
+bool Tesseract::LSTMRecognizeLineImage(Image pix, PointerVector<WERD_RES> *words) {
+  if (!AnyLSTMRecognizer() || pix == nullptr || pixGetWidth(pix) <= 0 ||
+      pixGetHeight(pix) <= 0) {
+    return false;
+  }
+  // Same input normalization as ImageThresholder::SetImage.
+  Image line_pix;
+  if (pixGetColormap(pix) != nullptr) {
+    line_pix = pixRemoveColormap(pix, REMOVE_CMAP_BASED_ON_SRC);
+  } else {
+    line_pix = pix.clone();
+  }
+  if (line_pix == nullptr) {
+    return false;
+  }
+  if (pixGetDepth(line_pix) < 8) {
+    Image grey = pixConvertTo8(line_pix, false);
+    line_pix.destroy();
+    line_pix = grey;
+  }
+  TBOX line_box(0, 0, pixGetWidth(line_pix), pixGetHeight(line_pix));
+  // ImageData takes ownership of line_pix.
+  ImageData im_data(false, line_pix);
+  float best_certainty = -FLT_MAX;
+  for (int i = -1; i < num_sub_langs(); ++i) {
+    Tesseract *lang_t = i < 0 ? this : get_sub_lang(i);
+    if (lang_t->lstm_recognizer_ == nullptr) {
+      continue;
+    }
+    PointerVector<WERD_RES> lang_words;
+    lang_t->LSTMRecognizeLineData(im_data, line_box, &lang_words);
+    float certainty_sum = 0.0f;
+    int num_words = 0;
+    for (unsigned w = 0; w < lang_words.size(); ++w) {
+      const WERD_RES *word = lang_words[w];
+      if (word->best_choice != nullptr && !word->best_choice->empty()) {
+        certainty_sum += word->best_choice->certainty();
+        ++num_words;
+      }
+    }
+    float certainty = num_words > 0 ? certainty_sum / num_words : -FLT_MAX;
+    if (words->empty() || certainty > best_certainty) {
+      best_certainty = certainty;
+      // Hand the words over to *words, which then owns them.
+      words->clear();
+      for (unsigned w = 0; w < lang_words.size(); ++w) {
+        words->push_back(lang_words[w]);
+        lang_words[w] = nullptr;
+      }
+    }
+  }
+  return true;
+}
+
+// Recognizes im_data as a single text line with the LSTM recognizer of this
+// language, converting to WERD_RES in *words.
+void Tesseract::LSTMRecognizeLineData(const ImageData &im_data, const TBOX &line_box,
+                                      PointerVector<WERD_RES> *words) {
+  bool do_invert = tessedit_do_invert;
+  float threshold = do_invert ? double(invert_threshold) : 0.0f;
+  lstm_recognizer_->SetUseDict(true);
+  lstm_recognizer_->SetNarrowBeam(false);
+  lstm_recognizer_->SetPredictPolarity(lstm_predict_polarity);
+  lstm_recognizer_->RecognizeLine(im_data, threshold, classify_debug_level > 0,
+                                  kWorstDictCertainty / kCertaintyScale, line_box, words,
+                                  lstm_choice_mode, lstm_choice_iterations);
+  SearchWords(words);
+}
+
 // Apply segmentation search to the given set of words, within the constraints
 // of the existing ratings matrix. If there is already a best_choice on a word
 // leaves it untouched and just sets the done/accepted etc flags.
@@ -254,7 +254,25 @@ int os_detect(TO_BLOCK_LIST *port_blocks, OSResults *osr, tesseract::Tesseract *
       filtered_it.add_to_end(bbox);
     }
   }
-  return os_detect_blobs(nullptr, &filtered_list, osr, tess);
+  return os_detect_blobs(nullptr, &filtered_list, osr, tess, tess->osd_fast,
+                         tess->min_orientation_margin);
+}
+
+// Returns true if the score of the best orientation in osr exceeds those of
+// all the others by at least margin.
+static bool OrientationMarginReached(const OSResults &osr, double margin) {
+  int best = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (osr.orientations[i] > osr.orientations[best]) {
+      best = i;
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    if (i != best && osr.orientations[best] - osr.orientations[i] < margin) {
+      return false;
+    }
+  }
+  return true;
 }
 
 // Detect orientation and script from a list of blobs.
@@ -263,11 +281,22 @@ int os_detect(TO_BLOCK_LIST *port_blocks, OSResults *osr, tesseract::Tesseract *
 // If allowed_scripts is non-null and non-empty, it is a list of scripts that
 // constrains both orientation and script detection to consider only scripts
 // from the list.
+// If fast, fewer blobs are tried, and detection stops once the best
+// orientation leads all the others by stop_margin, without waiting for the
+// script to be sure as well.
 int os_detect_blobs(const std::vector<int> *allowed_scripts, BLOBNBOX_CLIST *blob_list,
-                    OSResults *osr, tesseract::Tesseract *tess) {
+                    OSResults *osr, tesseract::Tesseract *tess, bool fast,
+                    double stop_margin) {
   OSResults osr_;
   int minCharactersToTry = tess->min_characters_to_try;
   int maxCharactersToTry = 5 * minCharactersToTry;
+  // The fast mode tries fewer blobs and stops as soon as the orientation
+  // is no longer weak, as judged by AutoPageSeg.
+  int minCharactersToStop = minCharactersToTry;
+  if (fast) {
+    maxCharactersToTry = 2 * minCharactersToTry;
+    minCharactersToStop = minCharactersToTry / 2;
+  }
   if (osr == nullptr) {
     osr = &osr_;
   }
@@ -296,7 +325,11 @@ int os_detect_blobs(const std::vector<int> *allowed_scripts, BLOBNBOX_CLIST *blo
   QRSequenceGenerator sequence(number_of_blobs);
   int num_blobs_evaluated = 0;
   for (int i = 0; i < real_max; ++i) {
-    if (os_detect_blob(blobs[sequence.GetVal()], &o, &s, osr, tess) && i > minCharactersToTry) {
+    bool stop = os_detect_blob(blobs[sequence.GetVal()], &o, &s, osr, tess);
+    if (fast && stop_margin > 0.0) {
+      stop = stop || OrientationMarginReached(*osr, stop_margin);
+    }
+    if (stop && i > minCharactersToStop) {
       break;
     }
     ++num_blobs_evaluated;
@@ -423,8 +456,8 @@ bool OrientationDetector::detect_blob(BLOB_CHOICE_LIST *scores) {
     osr_->orientations[i] += std::log(blob_o_score[i] / total_blob_o_score);
   }
 
-  // TODO(ranjith) Add an early exit test, based on min_orientation_margin,
-  // as used in pagesegmain.cpp.
+  // The early exit test, based on min_orientation_margin as used in
+  // pagesegmain.cpp, is made by os_detect_blobs in the fast mode.
   return false;
 }
 
@@ -52,6 +52,8 @@ namespace tesseract {
 
 // Max erosions to perform in removing an enclosing circle.
 const int kMaxCircleErosions = 8;
+// Max number of 2x reductions for layout analysis on a reduced image.
+const int kMaxLayoutReductions = 3;
 
 // Helper to remove an enclosing circle from an image.
 // If there isn't one, then the image will most likely get badly mangled.
@@ -136,9 +138,13 @@ int Tesseract::SegmentPage(const char *input_file, BLOCK_LIST *blocks, Tesseract
   TO_BLOCK_LIST to_blocks;
   if (PSM_OSD_ENABLED(pageseg_mode) || PSM_BLOCK_FIND_ENABLED(pageseg_mode) ||
       PSM_SPARSE(pageseg_mode)) {
-    auto_page_seg_ret_val =
-        AutoPageSeg(pageseg_mode, blocks, &to_blocks,
-                    enable_noise_removal ? &diacritic_blobs : nullptr, osd_tess, osr);
+    bool osd_done = false;
+    if (!ReducedPageSeg(pageseg_mode, blocks, osd_tess, osr, &auto_page_seg_ret_val,
+                        &osd_done)) {
+      auto_page_seg_ret_val =
+          AutoPageSeg(pageseg_mode, blocks, &to_blocks,
+                      enable_noise_removal ? &diacritic_blobs : nullptr, osd_tess, osr, osd_done);
+    }
     if (pageseg_mode == PSM_OSD_ONLY) {
       return auto_page_seg_ret_val;
     }
@@ -197,9 +203,12 @@ int Tesseract::SegmentPage(const char *input_file, BLOCK_LIST *blocks, Tesseract
  * performed. If osd is desired, (osd or only_osd) then osr_tess must be
  * another Tesseract that was initialized especially for osd, and the results
  * will be output into osr (orientation and script result).
+ * If osd_done is true, osr already holds the result of osd for this page,
+ * which is used without running osd again.
  */
 int Tesseract::AutoPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks, TO_BLOCK_LIST *to_blocks,
-                           BLOBNBOX_LIST *diacritic_blobs, Tesseract *osd_tess, OSResults *osr) {
+                           BLOBNBOX_LIST *diacritic_blobs, Tesseract *osd_tess, OSResults *osr,
+                           bool osd_done) {
   Image photomask_pix = nullptr;
   Image musicmask_pix = nullptr;
   // The blocks made by the ColumnFinder. Moved to blocks before return.
@@ -208,7 +217,7 @@ int Tesseract::AutoPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks, TO_BLOC
 
   ColumnFinder *finder = SetupPageSegAndDetectOrientation(
       pageseg_mode, blocks, osd_tess, osr, &temp_blocks, &photomask_pix,
-      pageseg_apply_music_mask ? &musicmask_pix : nullptr);
+      pageseg_apply_music_mask ? &musicmask_pix : nullptr, osd_done);
   int result = 0;
   if (finder != nullptr) {
     TO_BLOCK_IT to_block_it(&temp_blocks);
@@ -244,6 +253,108 @@ int Tesseract::AutoPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks, TO_BLOC
   return result;
 }
 
+/**
+ * Layout analysis on a reduced image. Finding the blocks works at text line
+ * scale, so on high resolution input it is run on pix_binary_ reduced by a
+ * power of 2, with a rank 1 reduction that keeps thin strokes. The blobs
+ * and text lines found there are thrown away and the blocks are scaled back
+ * up, so that TextordPage finds the blobs and lines in each text block of
+ * the full resolution image, as it does for blocks from a UNLV zone file.
+ * The rule lines removed from the reduced image are expanded back to full
+ * resolution and removed from pix_binary_ too. Noise is not separated out
+ * as diacritics.
+ * Pages with vertical or rotated text need their blobs rotated with the
+ * blocks, so they are segmented again at full resolution, reusing the
+ * orientation found here.
+ */
+bool Tesseract::ReducedPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks,
+                               Tesseract *osd_tess, OSResults *osr, int *result,
+                               bool *osd_done) {
+  if (pageseg_layout_max_resolution <= 0 || !PSM_BLOCK_FIND_ENABLED(pageseg_mode)) {
+    return false;
+  }
+#ifndef DISABLED_LEGACY_ENGINE
+  if (equ_detect_ != nullptr) {
+    return false;
+  }
+#endif // ndef DISABLED_LEGACY_ENGINE
+  int levels = 0;
+  while (levels < kMaxLayoutReductions &&
+         source_resolution_ > pageseg_layout_max_resolution << levels) {
+    ++levels;
+  }
+  if (levels == 0) {
+    return false;
+  }
+  int reduction = 1 << levels;
+  Image reduced = pixReduceRankBinaryCascade(pix_binary_, 1, levels > 1 ? 1 : 0,
+                                             levels > 2 ? 1 : 0, 0);
+  if (reduced == nullptr) {
+    return false;
+  }
+  if (textord_debug_tabfind) {
+    tprintf("Finding blocks at %d ppi on a %dx reduced image\n", source_resolution_ / reduction,
+            reduction);
+  }
+  // Line finding removes the rule lines from pix_binary_, so a copy of the
+  // reduced image is kept to find the pixels that were removed.
+  Image removed_pix = pixCopy(nullptr, reduced);
+  // AutoPageSeg works on the members, so swap the reduced image in and
+  // leave out the full resolution grey and threshold images.
+  Image full_binary = pix_binary_;
+  Image full_grey = pix_grey_;
+  Image full_thresholds = pix_thresholds_;
+  int full_resolution = source_resolution_;
+  pix_binary_ = reduced;
+  pix_grey_ = nullptr;
+  pix_thresholds_ = nullptr;
+  source_resolution_ = full_resolution / reduction;
+  BLOCK_LIST reduced_blocks;
+  BLOCK_IT block_it(&reduced_blocks);
+  auto *page_block =
+      new BLOCK("", true, 0, 0, 0, 0, pixGetWidth(reduced), pixGetHeight(reduced));
+  page_block->set_right_to_left(right_to_left());
+  block_it.add_to_end(page_block);
+  TO_BLOCK_LIST to_blocks;
+  int ret_val = AutoPageSeg(pageseg_mode, &reduced_blocks, &to_blocks, nullptr, osd_tess, osr);
+  *osd_done = PSM_OSD_ENABLED(pageseg_mode) && osd_tess != nullptr && osr != nullptr;
+  pixSubtract(removed_pix, removed_pix, pix_binary_);
+  pix_binary_.destroy();
+  pix_binary_ = full_binary;
+  pix_grey_ = full_grey;
+  pix_thresholds_ = full_thresholds;
+  source_resolution_ = full_resolution;
+  // Deleting the TO_BLOCKs deletes the reduced blobs with them.
+  to_blocks.clear();
+  ICOORD page_tr(pixGetWidth(pix_binary_), pixGetHeight(pix_binary_));
+  for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
+    BLOCK *block = block_it.data();
+    if (block->re_rotation().x() != 1.0f || block->classify_rotation().x() != 1.0f) {
+      if (textord_debug_tabfind) {
+        tprintf("Rotated block found, finding blocks at full resolution\n");
+      }
+      removed_pix.destroy();
+      return false;
+    }
+    block->blob_list()->clear();
+    block->reject_blobs()->clear();
+    block->scale_polygon(reduction, page_tr);
+  }
+  // Each removed pixel covers the reduction x reduction square of full
+  // resolution pixels that it was made from.
+  Image removed_full = pixExpandReplicate(removed_pix, reduction);
+  removed_pix.destroy();
+  if (removed_full != nullptr) {
+    pixSubtract(pix_binary_, pix_binary_, removed_full);
+    removed_full.destroy();
+  }
+  blocks->clear();
+  block_it.set_to_list(blocks);
+  block_it.add_list_after(&reduced_blocks);
+  *result = ret_val;
+  return true;
+}
+
 // Helper adds all the scripts from sid_set converted to ids from osd_set to
 // allowed_ids.
 static void AddAllScriptsConverted(const UNICHARSET &sid_set, const UNICHARSET &osd_set,
@@ -273,7 +384,8 @@ ColumnFinder *Tesseract::SetupPageSegAndDetectOrientation(PageSegMode pageseg_mo
                                                           BLOCK_LIST *blocks, Tesseract *osd_tess,
                                                           OSResults *osr, TO_BLOCK_LIST *to_blocks,
                                                           Image *photo_mask_pix,
-                                                          Image *music_mask_pix) {
+                                                          Image *music_mask_pix,
+                                                          bool osd_done) {
   int vertical_x = 0;
   int vertical_y = 1;
   TabVector_LIST v_lines;
@@ -363,7 +475,10 @@ ColumnFinder *Tesseract::SetupPageSegAndDetectOrientation(PageSegMode pageseg_mo
           AddAllScriptsConverted(lang->unicharset, osd_tess->unicharset, &osd_scripts);
         }
       }
-      os_detect_blobs(&osd_scripts, &osd_blobs, osr, osd_tess);
+      if (!osd_done) {
+        // Stop at the margin that is checked below.
+        os_detect_blobs(&osd_scripts, &osd_blobs, osr, osd_tess, osd_fast, min_orientation_margin);
+      }
       if (pageseg_mode == PSM_OSD_ONLY) {
         delete finder;
         return nullptr;
@@ -647,40 +647,45 @@ int ResultIterator::BlanksBeforeWord() const {
  * object at the given level. Use delete [] to free after use.
  */
 char *ResultIterator::GetUTF8Text(PageIteratorLevel level) const {
-  if (it_->word() == nullptr) {
+  std::string text;
+  if (!AppendUTF8Text(level, &text)) {
     return nullptr; // Already at the end!
   }
-  std::string text;
+  return copy_string(text);
+}
+
+bool ResultIterator::AppendUTF8Text(PageIteratorLevel level, std::string *text) const {
+  if (it_->word() == nullptr) {
+    return false; // Already at the end!
+  }
   switch (level) {
     case RIL_BLOCK: {
       ResultIterator pp(*this);
       do {
-        pp.AppendUTF8ParagraphText(&text);
+        pp.AppendUTF8ParagraphText(text);
       } while (pp.Next(RIL_PARA) && pp.it_->block() == it_->block());
     } break;
     case RIL_PARA:
-      AppendUTF8ParagraphText(&text);
+      AppendUTF8ParagraphText(text);
       break;
     case RIL_TEXTLINE: {
       ResultIterator it(*this);
       it.MoveToLogicalStartOfTextline();
-      it.IterateAndAppendUTF8TextlineText(&text);
+      it.IterateAndAppendUTF8TextlineText(text);
     } break;
     case RIL_WORD:
-      AppendUTF8WordText(&text);
+      AppendUTF8WordText(text);
       break;
-    case RIL_SYMBOL: {
-      bool reading_direction_is_ltr = current_paragraph_is_ltr_ ^ in_minor_direction_;
-      if (at_beginning_of_minor_run_) {
-        text += reading_direction_is_ltr ? kLRM : kRLM;
-      }
-      text = it_->word()->BestUTF8(blob_index_, false);
+    case RIL_SYMBOL:
+      // A directional mark at the beginning of a minor run is not part of
+      // the symbol.
+      *text += it_->word()->BestUTF8(blob_index_, false);
       if (IsAtFinalSymbolOfWord()) {
-        AppendSuffixMarks(&text);
+        AppendSuffixMarks(text);
       }
-    } break;
+      break;
   }
-  return copy_string(text);
+  return true;
 }
 std::vector<std::vector<std::vector<std::pair<const char *, float>>>>
     *ResultIterator::GetRawLSTMTimesteps() const {
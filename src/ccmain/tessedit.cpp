@@ -38,12 +38,20 @@
 #endif
 #include "lstmrecognizer.h"
 
+#include <cstring> // for strpbrk
+
 namespace tesseract {
 
 // Read a "config" file containing a set of variable, value pairs.
-// Searches the standard places: tessdata/configs, tessdata/tessconfigs
+// A plain config name is first looked up in the config bundle of the
+// traineddata, which needs no file access or parsing.
+// Otherwise searches the standard places: tessdata/configs, tessdata/tessconfigs
 // and also accepts a relative or absolute path name.
 void Tesseract::read_config_file(const char *filename, SetParamConstraint constraint) {
+  if (strpbrk(filename, "/\\") == nullptr && config_bundle_.HasConfig(filename)) {
+    config_bundle_.Apply(filename, constraint);
+    return;
+  }
   std::string path = datadir;
   path += "configs/";
   path += filename;
@@ -115,6 +123,19 @@ bool Tesseract::init_tesseract_lang_data(const std::string &language, OcrEngineM
     ParamUtils::ReadParamsFromFp(SET_PARAM_CONSTRAINT_NONE, &fp, this->params());
   }
 
+  // Named configs precompiled into the traineddata replace the files of the
+  // same name in the tessdata directory.
+  config_bundle_.Clear();
+  if (mgr->GetComponent(TESSDATA_CONFIG_BUNDLE, &fp)) {
+    if (!config_bundle_.DeSerialize(&fp)) {
+      tprintf("Warning: Ignoring invalid config bundle in %s\n",
+              mgr->GetDataFileName().c_str());
+    } else {
+      // The parameters are looked up once here instead of at every Init.
+      config_bundle_.Resolve(this->params());
+    }
+  }
+
   SetParamConstraint set_params_constraint =
       set_only_non_debug_params ? SET_PARAM_CONSTRAINT_NON_DEBUG_ONLY : SET_PARAM_CONSTRAINT_NONE;
   // Load tesseract variables from config files. This is done after loading
@@ -48,6 +48,9 @@
 #include "lstmrecognizer.h"
 #include "thresholder.h" // for ThresholdMethod
 
+#include <cstring> // for strpbrk
+#include <string>
+
 namespace tesseract {
 
 Tesseract::Tesseract()
@@ -71,6 +74,10 @@ Tesseract::Tesseract()
     , double_MEMBER(invert_threshold, 0.7,
                     "For lines with a mean confidence below this value, OCR is also tried with an inverted image",
                     this->params())
+    , BOOL_MEMBER(lstm_predict_polarity, false,
+                  "With invert_threshold, try first the polarity that the grey histogram "
+                  "of the line suggests",
+                  this->params())
     ,
     // The default for pageseg_mode is the old behaviour, so as not to
     // upset anything that relies on that.
@@ -84,7 +91,7 @@ Tesseract::Tesseract()
     , INT_MEMBER(thresholding_method,
                  static_cast<int>(ThresholdMethod::Otsu),
                  "Thresholding method: 0 = Otsu, 1 = LeptonicaOtsu, 2 = "
-                 "Sauvola",
+                 "Sauvola, 3 = IntegralSauvola",
                  this->params())
     , BOOL_MEMBER(thresholding_debug, false,
                   "Debug the thresholding process",
@@ -164,6 +171,10 @@ Tesseract::Tesseract()
     , BOOL_MEMBER(tessedit_display_outwords, false, "Draw output words", this->params())
     , BOOL_MEMBER(tessedit_dump_choices, false, "Dump char choices", this->params())
     , BOOL_MEMBER(tessedit_timing_debug, false, "Print timing stats", this->params())
+    , INT_MEMBER(tessedit_time_budget_msecs, 0,
+                 "Soft time budget of a page in ms: recognition drops costly settings"
+                 " instead of stopping when it falls behind (0 = no budget)",
+                 this->params())
     , BOOL_MEMBER(tessedit_fix_fuzzy_spaces, true, "Try to improve fuzzy spaces", this->params())
     , BOOL_MEMBER(tessedit_unrej_any_wd, false, "Don't bother with word plausibility",
                   this->params())
@@ -388,6 +399,10 @@ Tesseract::Tesseract()
     , BOOL_MEMBER(tessedit_create_boxfile, false, "Output text with boxes", this->params())
     , INT_MEMBER(tessedit_page_number, -1, "-1 -> All pages, else specific page to process",
                  this->params())
+    , INT_MEMBER(tessedit_parallel_pages, 1,
+                 "Number of pages of a multipage input to recognize at once, each on its own"
+                 " engine (0 = one per hardware thread)",
+                 this->params())
     , BOOL_MEMBER(tessedit_write_images, false, "Capture the image from the IPE", this->params())
     , BOOL_MEMBER(interactive_display_mode, false, "Run interactively?", this->params())
     , STRING_MEMBER(file_type, ".tif", "Filename extension", this->params())
@@ -400,6 +415,10 @@ Tesseract::Tesseract()
                   this->params())
     , double_MEMBER(min_orientation_margin, 7.0, "Min acceptable orientation margin",
                     this->params())
+    , BOOL_MEMBER(osd_fast, false,
+                  "Try at most twice min_characters_to_try blobs in OSD and stop once the "
+                  "orientation leads by min_orientation_margin",
+                  this->params())
     , BOOL_MEMBER(textord_tabfind_show_vlines, false, "Debug line finding", this->params())
     , BOOL_MEMBER(textord_use_cjk_fp_model, false, "Use CJK fixed pitch model", this->params())
     , BOOL_MEMBER(poly_allow_detailed_fx, false,
@@ -447,6 +466,10 @@ Tesseract::Tesseract()
                     this->params())
     , BOOL_MEMBER(pageseg_apply_music_mask, false,
                   "Detect music staff and remove intersecting components", this->params())
+    , INT_MEMBER(pageseg_layout_max_resolution, 0,
+                 "If > 0, find the blocks of images of a higher resolution on a binary "
+                 "image reduced by a power of 2 to at most this resolution",
+                 this->params())
     ,
 
     backup_config_file_(nullptr)
@@ -461,6 +484,7 @@ Tesseract::Tesseract()
     , reskew_(1.0f, 0.0f)
     , gradient_(0.0f)
     , most_recently_used_(this)
+    , degradations_(0)
     , font_table_size_(0)
 #ifndef DISABLED_LEGACY_ENGINE
     , equ_detect_(nullptr)
@@ -497,6 +521,7 @@ void Tesseract::Clear() {
   deskew_ = FCOORD(1.0f, 0.0f);
   reskew_ = FCOORD(1.0f, 0.0f);
   gradient_ = 0.0f;
+  degradations_ = 0;
   splitter_.Clear();
   for (auto &sub_lang : sub_langs_) {
     sub_lang->Clear();
@@ -518,6 +543,55 @@ void Tesseract::ResetAdaptiveClassifier() {
   }
 }
 
+// Returns the file name, without suffix, of the adapted templates of lang
+// for document_class in dir, or an empty string if document_class is not a
+// plain name.
+static std::string AdaptedTemplatesBasename(const std::string &dir, const std::string &lang,
+                                            const char *document_class) {
+  if (document_class == nullptr || *document_class == '\0' ||
+      strpbrk(document_class, "/\\") != nullptr) {
+    return "";
+  }
+  std::string basename = dir;
+  if (!basename.empty() && basename.back() != '/') {
+    basename += '/';
+  }
+  basename += document_class;
+  basename += '.';
+  basename += lang;
+  return basename;
+}
+
+// Saves the adapted templates of this and all subclassifiers.
+bool Tesseract::SaveAdaptedTemplates(const char *document_class) {
+  const std::string &dir = classify_adapted_templates_dir;
+  std::string basename = AdaptedTemplatesBasename(dir, lang, document_class);
+  if (basename.empty()) {
+    return false;
+  }
+  bool success = SaveAdaptedTemplatesTo(basename);
+  for (auto &sub_lang : sub_langs_) {
+    basename = AdaptedTemplatesBasename(dir, sub_lang->lang, document_class);
+    success &= sub_lang->SaveAdaptedTemplatesTo(basename);
+  }
+  return success;
+}
+
+// Loads the adapted templates of this and all subclassifiers.
+bool Tesseract::LoadAdaptedTemplates(const char *document_class, bool merge) {
+  const std::string &dir = classify_adapted_templates_dir;
+  std::string basename = AdaptedTemplatesBasename(dir, lang, document_class);
+  if (basename.empty()) {
+    return false;
+  }
+  bool success = LoadAdaptedTemplatesFrom(basename, merge);
+  for (auto &sub_lang : sub_langs_) {
+    basename = AdaptedTemplatesBasename(dir, sub_lang->lang, document_class);
+    success &= sub_lang->LoadAdaptedTemplatesFrom(basename, merge);
+  }
+  return success;
+}
+
 #endif // ndef DISABLED_LEGACY_ENGINE
 
 // Clear the document dictionary for this and all subclassifiers.
@@ -29,6 +29,7 @@
 #  include "config_auto.h" // DISABLED_LEGACY_ENGINE
 #endif
 
+#include "configbundle.h"          // for ConfigBundle
 #include "control.h"               // for ACCEPTABLE_WERD_TYPE
 #include "debugpixa.h"             // for DebugPixa
 #include "devanagari_processing.h" // for ShiroRekhaSplitter
@@ -48,6 +49,7 @@
 #include <tesseract/publictypes.h> // for OcrEngineMode, PageSegMode, OEM_L...
 #include <tesseract/unichar.h>     // for UNICHAR_ID
 
+#include <chrono>  // for std::chrono::steady_clock
 #include <cstdint> // for int16_t, int32_t, uint16_t
 #include <cstdio>  // for FILE
 
@@ -187,6 +189,15 @@ public:
   void Clear();
   // Clear all memory of adaption for this and all subclassifiers.
   void ResetAdaptiveClassifier();
+  // Saves the adapted templates of this and all subclassifiers for the given
+  // document class, as <classify_adapted_templates_dir>/<class>.<lang>.a.
+  // Returns false if any of them could not be saved.
+  bool SaveAdaptedTemplates(const char *document_class);
+  // Loads the adapted templates saved for the given document class into
+  // this and all subclassifiers, merging them with what has already been
+  // learned if merge is true. Returns false if any of them could not be
+  // loaded.
+  bool LoadAdaptedTemplates(const char *document_class, bool merge);
   // Clear the document dictionary for this and all subclassifiers.
   void ResetDocumentDictionary();
 
@@ -246,6 +257,9 @@ public:
       return pix_binary_;
     }
   }
+  Image pix_thresholds() const {
+    return pix_thresholds_;
+  }
   void set_pix_thresholds(Image thresholds) {
     pix_thresholds_.destroy();
     pix_thresholds_ = thresholds;
@@ -278,6 +292,10 @@ public:
   Tesseract *get_sub_lang(int index) const {
     return sub_langs_[index];
   }
+  // Returns the LSTM recognizer, or nullptr if none is loaded.
+  LSTMRecognizer *lstm_recognizer() const {
+    return lstm_recognizer_;
+  }
   // Returns true if any language uses Tesseract (as opposed to LSTM).
   bool AnyTessLang() const {
     if (tessedit_ocr_engine_mode != OEM_LSTM_ONLY) {
@@ -290,6 +308,18 @@ public:
     }
     return false;
   }
+  // Returns true if this or any sub language has an LSTM recognizer loaded.
+  bool AnyLSTMRecognizer() const {
+    if (lstm_recognizer_ != nullptr) {
+      return true;
+    }
+    for (auto &lang : sub_langs_) {
+      if (lang->lstm_recognizer_ != nullptr) {
+        return true;
+      }
+    }
+    return false;
+  }
   // Returns true if any language uses the LSTM.
   bool AnyLSTMLang() const {
     if (tessedit_ocr_engine_mode != OEM_TESSERACT_ONLY) {
@@ -321,11 +351,23 @@ public:
   int SegmentPage(const char *input_file, BLOCK_LIST *blocks, Tesseract *osd_tess, OSResults *osr);
   void SetupWordScripts(BLOCK_LIST *blocks);
   int AutoPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks, TO_BLOCK_LIST *to_blocks,
-                  BLOBNBOX_LIST *diacritic_blobs, Tesseract *osd_tess, OSResults *osr);
+                  BLOBNBOX_LIST *diacritic_blobs, Tesseract *osd_tess, OSResults *osr,
+                  bool osd_done = false);
+  // Runs AutoPageSeg on pix_binary_ reduced to at most
+  // pageseg_layout_max_resolution and scales the blocks it finds back up
+  // into blocks, leaving the text lines to be found at full resolution.
+  // The rule lines removed from the reduced image are removed from
+  // pix_binary_ as well.
+  // Returns false, with blocks and pix_binary_ untouched, if the page should
+  // be segmented at full resolution instead, with *osd_done set if osr
+  // already holds the orientation and script of the page. Otherwise the
+  // return value of AutoPageSeg goes in *result.
+  bool ReducedPageSeg(PageSegMode pageseg_mode, BLOCK_LIST *blocks, Tesseract *osd_tess,
+                      OSResults *osr, int *result, bool *osd_done);
   ColumnFinder *SetupPageSegAndDetectOrientation(PageSegMode pageseg_mode, BLOCK_LIST *blocks,
                                                  Tesseract *osd_tess, OSResults *osr,
                                                  TO_BLOCK_LIST *to_blocks, Image *photo_mask_pix,
-                                                 Image *music_mask_pix);
+                                                 Image *music_mask_pix, bool osd_done = false);
   // par_control.cpp
   void PrerecAllWordsPar(const std::vector<WordData> &words);
 
@@ -360,6 +402,16 @@ public:
   // Analogous to classify_word_pass1, but can handle a group of words as well.
   void LSTMRecognizeWord(const BLOCK &block, ROW *row, WERD_RES *word,
                          PointerVector<WERD_RES> *words);
+  // Recognizes the whole of pix as a single text line with the LSTM
+  // recognizer of each language, skipping thresholding and layout analysis,
+  // and keeps the words of the language with the best mean certainty. Word
+  // and blob boxes are in pix coordinates with the origin at the bottom-left.
+  // Returns false if there is no LSTM recognizer or no usable image.
+  bool LSTMRecognizeLineImage(Image pix, PointerVector<WERD_RES> *words);
+  // Recognizes im_data as a single text line with the LSTM recognizer of
+  // this language.
+  void LSTMRecognizeLineData(const ImageData &im_data, const TBOX &line_box,
+                             PointerVector<WERD_RES> *words);
   // Apply segmentation search to the given set of words, within the constraints
   // of the existing ratings matrix. If there is already a best_choice on a word
   // leaves it untouched and just sets the done/accepted etc flags.
@@ -376,8 +428,23 @@ public:
   // Runs word recognition on all the words.
   bool RecogAllWordsPassN(int pass_n, ETEXT_DESC *monitor, PAGE_RES_IT *pr_it,
                           std::vector<WordData> *words);
+  // Sets the RecognitionDegradation flags to recognize the following words
+  // with, in this and all sub_langs_.
+  void SetDegradations(int degradations);
+  // Returns the RecognitionDegradation flags applied since StartTimeBudget.
+  int degradations() const {
+    return degradations_;
+  }
+  // Starts the time budget of tessedit_time_budget_msecs for a page from now
+  // and clears the degradations.
+  void StartTimeBudget();
+  // Returns the fraction of the time budget used since StartTimeBudget, or 0
+  // if there is no budget.
+  double TimeBudgetUsed() const;
   bool recog_all_words(PAGE_RES *page_res, ETEXT_DESC *monitor, const TBOX *target_word_box,
                        const char *word_config, int dopasses);
+  // Prints the polarity decisions of the LSTM recognizer for the last page.
+  void ReportPolarityCounts() const;
   void rejection_passes(PAGE_RES *page_res, ETEXT_DESC *monitor, const TBOX *target_word_box,
                         const char *word_config);
   void bigram_correction_pass(PAGE_RES *page_res);
@@ -481,6 +548,8 @@ public:
   int16_t count_alphanums(const WERD_CHOICE &word);
   int16_t count_alphas(const WERD_CHOICE &word);
 
+  // Applies the named config from the config-bundle component of the
+  // traineddata if it has one, otherwise reads the named config file.
   void read_config_file(const char *filename, SetParamConstraint constraint);
   // Initialize for potentially a set of languages defined by the language
   // string and recursively any additional languages required by any language
@@ -751,6 +820,7 @@ public:
   // TODO: remove deprecated tessedit_do_invert in release 6.
   BOOL_VAR_H(tessedit_do_invert);
   double_VAR_H(invert_threshold);
+  BOOL_VAR_H(lstm_predict_polarity);
   INT_VAR_H(tessedit_pageseg_mode);
   INT_VAR_H(thresholding_method);
   BOOL_VAR_H(thresholding_debug);
@@ -777,6 +847,7 @@ public:
   BOOL_VAR_H(tessedit_display_outwords);
   BOOL_VAR_H(tessedit_dump_choices);
   BOOL_VAR_H(tessedit_timing_debug);
+  INT_VAR_H(tessedit_time_budget_msecs);
   BOOL_VAR_H(tessedit_fix_fuzzy_spaces);
   BOOL_VAR_H(tessedit_unrej_any_wd);
   BOOL_VAR_H(tessedit_fix_hyphens);
@@ -931,6 +1002,7 @@ public:
   INT_VAR_H(min_sane_x_ht_pixels);
   BOOL_VAR_H(tessedit_create_boxfile);
   INT_VAR_H(tessedit_page_number);
+  INT_VAR_H(tessedit_parallel_pages);
   BOOL_VAR_H(tessedit_write_images);
   BOOL_VAR_H(interactive_display_mode);
   STRING_VAR_H(file_type);
@@ -940,6 +1012,7 @@ public:
   // Min acceptable orientation margin (difference in scores between top and 2nd
   // choice in OSResults::orientations) to believe the page orientation.
   double_VAR_H(min_orientation_margin);
+  BOOL_VAR_H(osd_fast);
   BOOL_VAR_H(textord_tabfind_show_vlines);
   BOOL_VAR_H(textord_use_cjk_fp_model);
   BOOL_VAR_H(poly_allow_detailed_fx);
@@ -958,6 +1031,7 @@ public:
   INT_VAR_H(lstm_choice_iterations);
   double_VAR_H(lstm_rating_coefficient);
   BOOL_VAR_H(pageseg_apply_music_mask);
+  INT_VAR_H(pageseg_layout_max_resolution);
 
   //// ambigsrecog.cpp /////////////////////////////////////////////////////////
   FILE *init_recog_training(const char *filename);
@@ -972,6 +1046,8 @@ private:
   const char *backup_config_file_;
   // The filename of a config file to read when processing a debug word.
   std::string word_config_;
+  // Precompiled named configs from the traineddata, if it has any.
+  ConfigBundle config_bundle_;
   // Image used for input to layout analysis and tesseract recognition.
   // May be modified by the ShiroRekhaSplitter to eliminate the top-line.
   Image pix_binary_;
@@ -1002,6 +1078,11 @@ private:
   // Most recently used Tesseract out of this and sub_langs_. The default
   // language for the next word.
   Tesseract *most_recently_used_;
+  // RecognitionDegradation flags that word recognition currently applies to
+  // keep to the time budget of the page.
+  int degradations_;
+  // When the time budget of the page started.
+  std::chrono::steady_clock::time_point budget_start_;
   // The size of the font table, ie max possible font id + 1.
   int font_table_size_;
 #ifndef DISABLED_LEGACY_ENGINE
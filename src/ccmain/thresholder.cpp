@@ -21,6 +21,7 @@
 #  include "config_auto.h"
 #endif
 
+#include "helpers.h" // for ClipToRange
 #include "image.h"   // for Image
 #include "otsuthr.h"
 #include "thresholder.h"
@@ -29,12 +30,31 @@
 #include <tesseract/baseapi.h> // for api->GetIntVariable()
 
 #include <algorithm> // for std::max, std::min
+#include <cmath>     // for sqrt
 #include <cstdint>   // for uint32_t
 #include <cstring>
 #include <tuple>
+#include <vector>    // for std::vector
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
 
 namespace tesseract {
 
+#ifdef _OPENMP
+// Max number of threads used to binarize the rows of an image. Beyond this
+// the loops are limited by memory bandwidth.
+const int kMaxThresholdThreads = 8;
+
+// Returns the number of threads to binarize with: as many as a parallel
+// region started on this thread would get, which is 1 on the engine threads
+// of the page pool, up to kMaxThresholdThreads.
+static int NumThresholdThreads() {
+  return std::max(1, std::min(omp_get_max_threads(), kMaxThresholdThreads));
+}
+#endif
+
 ImageThresholder::ImageThresholder()
     : pix_(nullptr)
     , image_width_(0)
@@ -124,8 +144,9 @@ void ImageThresholder::SetImage(const unsigned char *imagedata, int width, int h
     default:
       tprintf("Cannot convert RAW image to Pix with bpp = %d\n", bpp);
   }
-  SetImage(pix);
-  pix.destroy();
+  // pix is already binary, 8 bit or RGB and nobody else has it, so there is
+  // no need for SetImage to make another copy.
+  TakeImage(pix);
 }
 
 // Store the coordinates of the rectangle to process for later use.
@@ -157,28 +178,156 @@ void ImageThresholder::GetImageSizes(int *left, int *top, int *width, int *heigh
 // immediately after, but may not go away until after the Thresholder has
 // finished with it.
 void ImageThresholder::SetImage(const Image pix) {
-  if (pix_ != nullptr) {
-    pix_.destroy();
-  }
   Image src = pix;
-  int depth;
-  pixGetDimensions(src, &image_width_, &image_height_, &depth);
+  int depth = pixGetDepth(src);
   // Convert the image as necessary so it is one of binary, plain RGB, or
   // 8 bit with no colormap. Guarantee that we always end up with our own copy,
   // not just a clone of the input.
   if (depth > 1 && depth < 8) {
-    pix_ = pixConvertTo8(src, false);
+    TakeImage(pixConvertTo8(src, false));
+  } else {
+    TakeImage(src.copy());
+  }
+}
+
+// As SetImage, but if pix is already binary, 8 bit grey or 32 bit RGB
+// without a colormap it is cloned rather than copied, and the thresholder
+// and everything that gets the image from GetPixRect reads its pixels in
+// place. The pixels must then stay unmodified until the next SetImage or
+// Clear. Other formats are converted as by SetImage.
+void ImageThresholder::SetBorrowedImage(const Image pix) {
+  int depth = pixGetDepth(pix);
+  if ((depth == 1 || depth == 8 || depth == 32) && pixGetColormap(pix) == nullptr) {
+    TakeImage(pix.clone());
   } else {
-    pix_ = src.copy();
+    SetImage(pix);
   }
-  depth = pixGetDepth(pix_);
-  pix_channels_ = depth / 8;
+}
+
+// Makes pix, which must be binary, 8 bit or 32 bit, the source image and
+// takes ownership of it.
+void ImageThresholder::TakeImage(Image pix) {
+  pix_.destroy();
+  pix_ = pix;
+  pixGetDimensions(pix_, &image_width_, &image_height_, nullptr);
+  pix_channels_ = pixGetDepth(pix_) / 8;
   pix_wpl_ = pixGetWpl(pix_);
   scale_ = 1;
   estimated_res_ = yres_ = pixGetYRes(pix_);
   Init();
 }
 
+// Minimum height of the strips that IntegralSauvolaThreshold binarizes in
+// parallel. Each strip has to sum the window rows above its first row again.
+#ifdef _OPENMP
+const int kMinSauvolaStripHeight = 256;
+#endif
+
+// Sauvola thresholds rows [y_begin, y_end) of the 8 bit grey image to the
+// thresholds and binary images of the same size. Keeps the sums of values
+// and squared values of each column over the rows of the window, updated
+// as the window moves down, and a running sum of those along the row, so
+// the cost does not depend on the window size and the memory needed is a
+// few rows.
+static void IntegralSauvolaStrip(const uint32_t *grey, int grey_wpl, int width, int height,
+                                 int half_window_size, double kfactor, int y_begin, int y_end,
+                                 uint32_t *thresholds, int thresholds_wpl, uint32_t *binary,
+                                 int binary_wpl) {
+  std::vector<int64_t> column_sums(width);
+  std::vector<int64_t> column_squares(width);
+  std::vector<int64_t> row_sums(width + 1);
+  std::vector<int64_t> row_squares(width + 1);
+  auto add_row = [&](int y, int sign) {
+    const uint32_t *line = grey + y * grey_wpl;
+    for (int x = 0; x < width; ++x) {
+      int64_t value = Image::getDataByte(line, x);
+      column_sums[x] += sign * value;
+      column_squares[x] += sign * value * value;
+    }
+  };
+  int first_row = std::max(0, y_begin - half_window_size);
+  int last_row = std::min(height - 1, y_begin + half_window_size);
+  for (int y = first_row; y <= last_row; ++y) {
+    add_row(y, 1);
+  }
+  for (int y = y_begin; y < y_end; ++y) {
+    if (y > y_begin) {
+      if (y + half_window_size < height) {
+        add_row(y + half_window_size, 1);
+      }
+      if (y - half_window_size - 1 >= 0) {
+        add_row(y - half_window_size - 1, -1);
+      }
+    }
+    int num_rows = std::min(height - 1, y + half_window_size) -
+                   std::max(0, y - half_window_size) + 1;
+    for (int x = 0; x < width; ++x) {
+      row_sums[x + 1] = row_sums[x] + column_sums[x];
+      row_squares[x + 1] = row_squares[x] + column_squares[x];
+    }
+    const uint32_t *line = grey + y * grey_wpl;
+    uint32_t *threshold_line = thresholds + y * thresholds_wpl;
+    uint32_t *binary_line = binary + y * binary_wpl;
+    uint32_t word = 0;
+    for (int x = 0; x < width; ++x) {
+      int left = std::max(0, x - half_window_size);
+      int right = std::min(width - 1, x + half_window_size);
+      double count = static_cast<double>(num_rows) * (right - left + 1);
+      double mean = (row_sums[right + 1] - row_sums[left]) / count;
+      double variance = (row_squares[right + 1] - row_squares[left]) / count - mean * mean;
+      double deviation = variance > 0.0 ? sqrt(variance) : 0.0;
+      int threshold = ClipToRange(
+          static_cast<int>(mean * (1.0 - kfactor * (1.0 - deviation / 128.0))), 0, 255);
+      Image::setDataByte(threshold_line, x, threshold);
+      word = (word << 1) | (Image::getDataByte(line, x) < threshold);
+      if ((x & 31) == 31) {
+        binary_line[x >> 5] = word;
+        word = 0;
+      }
+    }
+    int tail = width & 31;
+    if (tail != 0) {
+      binary_line[width >> 5] = word << (32 - tail);
+    }
+  }
+}
+
+// Sauvola binarization of the 8 bit pix_grey with a window of
+// 2 * half_window_size + 1 pixels. Unlike pixSauvolaBinarizeTiled it does
+// not make intermediate images, and near the image borders it uses the
+// part of the window that is inside the image instead of mirroring it.
+// With OpenMP, strips of rows are binarized in parallel.
+static void IntegralSauvolaThreshold(Image pix_grey, int half_window_size, double kfactor,
+                                     Image *pix_thresholds, Image *pix_binary) {
+  int width = pixGetWidth(pix_grey);
+  int height = pixGetHeight(pix_grey);
+  *pix_thresholds = pixCreate(width, height, 8);
+  *pix_binary = pixCreate(width, height, 1);
+  pixSetXRes(*pix_binary, pixGetXRes(pix_grey));
+  pixSetYRes(*pix_binary, pixGetYRes(pix_grey));
+  const uint32_t *grey = pixGetData(pix_grey);
+  int grey_wpl = pixGetWpl(pix_grey);
+  uint32_t *thresholds = pixGetData(*pix_thresholds);
+  int thresholds_wpl = pixGetWpl(*pix_thresholds);
+  uint32_t *binary = pixGetData(*pix_binary);
+  int binary_wpl = pixGetWpl(*pix_binary);
+#ifdef _OPENMP
+  int strip_height = std::max(kMinSauvolaStripHeight, 4 * half_window_size);
+#else
+  int strip_height = std::max(1, height);
+#endif
+  int num_strips = (height + strip_height - 1) / strip_height;
+#ifdef _OPENMP
+#  pragma omp parallel for num_threads(NumThresholdThreads())
+#endif
+  for (int strip = 0; strip < num_strips; ++strip) {
+    int y_begin = strip * strip_height;
+    int y_end = std::min(height, y_begin + strip_height);
+    IntegralSauvolaStrip(grey, grey_wpl, width, height, half_window_size, kfactor, y_begin,
+                         y_end, thresholds, thresholds_wpl, binary, binary_wpl);
+  }
+}
+
 std::tuple<bool, Image, Image, Image> ImageThresholder::Threshold(
                                                       TessBaseAPI *api,
                                                       ThresholdMethod method) {
@@ -207,7 +356,8 @@ std::tuple<bool, Image, Image, Image> ImageThresholder::Threshold(
     tprintf("\nimage width: %d  height: %d  ppi: %d\n", pix_w, pix_h, yres_);
   }
 
-  if (method == ThresholdMethod::Sauvola && pix_w > 6 && pix_h > 6) {
+  if ((method == ThresholdMethod::Sauvola || method == ThresholdMethod::IntegralSauvola) &&
+      pix_w > 6 && pix_h > 6) {
     // pixSauvolaBinarizeTiled requires half_window_size >= 2.
     // Therefore window_size must be at least 4 which requires
     // pix_w and pix_h to be at least 7.
@@ -241,9 +391,14 @@ std::tuple<bool, Image, Image, Image> ImageThresholder::Threshold(
       tprintf("window size: %d  kfactor: %.3f  nx:%d  ny: %d\n", window_size, kfactor, nx, ny);
     }
 
-    r = pixSauvolaBinarizeTiled(pix_grey, half_window_size, kfactor, nx, ny,
-                                static_cast<PIX **>(pix_thresholds),
-                                static_cast<PIX **>(pix_binary));
+    if (method == ThresholdMethod::IntegralSauvola) {
+      IntegralSauvolaThreshold(pix_grey, half_window_size, kfactor, &pix_thresholds, &pix_binary);
+      r = 0;
+    } else {
+      r = pixSauvolaBinarizeTiled(pix_grey, half_window_size, kfactor, nx, ny,
+                                  static_cast<PIX **>(pix_thresholds),
+                                  static_cast<PIX **>(pix_binary));
+    }
   } else { // if (method == ThresholdMethod::LeptonicaOtsu)
     int tile_size;
     double tile_size_factor;
@@ -397,24 +552,44 @@ void ImageThresholder::ThresholdRectToPix(Image src_pix, int num_channels, const
   uint32_t *srcdata = pixGetData(src_pix);
   pixSetXRes(*pix, pixGetXRes(src_pix));
   pixSetYRes(*pix, pixGetYRes(src_pix));
+  // Decide once for every value of every channel whether it is foreground,
+  // so the loop below has no comparisons.
+  std::vector<uint8_t> foreground(num_channels * kHistogramSize);
+  for (int ch = 0; ch < num_channels; ++ch) {
+    if (hi_values[ch] < 0) {
+      continue;
+    }
+    for (int value = 0; value < kHistogramSize; ++value) {
+      foreground[ch * kHistogramSize + value] = (value > thresholds[ch]) == (hi_values[ch] == 0);
+    }
+  }
+  const uint8_t *is_foreground = foreground.data();
+  // Rows are independent, and each output row is assembled 32 pixels at a
+  // time and stored a word at a time.
+#ifdef _OPENMP
+#  pragma omp parallel for num_threads(NumThresholdThreads())
+#endif
   for (int y = 0; y < rect_height_; ++y) {
     const uint32_t *linedata = srcdata + (y + rect_top_) * src_wpl;
     uint32_t *pixline = pixdata + y * wpl;
+    uint32_t word = 0;
+    int n = rect_left_ * num_channels;
     for (int x = 0; x < rect_width_; ++x) {
-      bool white_result = true;
-      for (int ch = 0; ch < num_channels; ++ch) {
-        int pixel = Image::getDataByte(linedata, (x + rect_left_) * num_channels + ch);
-        if (hi_values[ch] >= 0 && (pixel > thresholds[ch]) == (hi_values[ch] == 0)) {
-          white_result = false;
-          break;
-        }
+      uint32_t black = 0;
+      for (int ch = 0; ch < num_channels; ++ch, ++n) {
+        black |= is_foreground[ch * kHistogramSize + Image::getDataByte(linedata, n)];
       }
-      if (white_result) {
-        Image::clearDataBit(pixline, x);
-      } else {
-        Image::setDataBit(pixline, x);
+      word = (word << 1) | black;
+      if ((x & 31) == 31) {
+        pixline[x >> 5] = word;
+        word = 0;
       }
     }
+    int tail = rect_width_ & 31;
+    if (tail != 0) {
+      // The first pixel of a word is its most significant bit.
+      pixline[rect_width_ >> 5] = word << (32 - tail);
+    }
   }
 }
 
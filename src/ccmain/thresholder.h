@@ -28,10 +28,11 @@ struct Pix;
 namespace tesseract {
 
 enum class ThresholdMethod {
-  Otsu,          // Tesseract's legacy Otsu
-  LeptonicaOtsu, // Leptonica's Otsu
-  Sauvola,       // Leptonica's Sauvola
-  Max,           // Number of Thresholding methods
+  Otsu,            // Tesseract's legacy Otsu
+  LeptonicaOtsu,   // Leptonica's Otsu
+  Sauvola,         // Leptonica's Sauvola
+  IntegralSauvola, // Tesseract's Sauvola, with running window sums
+  Max,             // Number of Thresholding methods
 };
 
 class TessBaseAPI;
@@ -123,6 +124,12 @@ public:
   /// finished with it.
   void SetImage(const Image pix);
 
+  /// As SetImage, but a binary, 8 bit grey or 32 bit RGB pix without a
+  /// colormap is used in place instead of being copied. Its pixels must not
+  /// be modified until the next SetImage or Clear. Other formats are
+  /// converted as they are by SetImage.
+  void SetBorrowedImage(const Image pix);
+
   /// Threshold the source image as efficiently as possible to the output Pix.
   /// Creates a Pix and sets pix to point to the resulting pointer.
   /// Caller must use pixDestroy to free the created Pix.
@@ -161,6 +168,10 @@ protected:
   /// Common initialization shared between SetImage methods.
   virtual void Init();
 
+  /// Makes pix, which must be binary, 8 bit or 32 bit, the source image,
+  /// taking ownership of it.
+  void TakeImage(Image pix);
+
   /// Return true if we are processing the full image.
   bool IsFullImage() const {
     return rect_left_ == 0 && rect_top_ == 0 && rect_width_ == image_width_ &&
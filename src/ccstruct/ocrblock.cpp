@@ -18,6 +18,7 @@
 
 #include "ocrblock.h"
 
+#include "helpers.h" // for ClipToRange
 #include "stepblob.h"
 #include "tprintf.h"
 
@@ -83,6 +84,43 @@ void BLOCK::rotate(const FCOORD &rotation) {
   pdblk.box = *pdblk.poly_block()->bounding_box();
 }
 
+// Helper scales the points of list by factor about the origin, moving
+// those above or right of the middle of box out by factor - 1, and clips
+// them to the page.
+static void ScalePoints(int factor, const TBOX &box, const ICOORD &page_tr,
+                        ICOORDELT_LIST *list) {
+  ICOORDELT_IT it(list);
+  for (it.mark_cycle_pt(); !it.cycled_list(); it.forward()) {
+    ICOORDELT *pt = it.data();
+    int x = pt->x() * factor;
+    int y = pt->y() * factor;
+    if (2 * pt->x() > box.left() + box.right()) {
+      x += factor - 1;
+    }
+    if (2 * pt->y() > box.bottom() + box.top()) {
+      y += factor - 1;
+    }
+    pt->set_x(ClipToRange<int>(x, 0, page_tr.x()));
+    pt->set_y(ClipToRange<int>(y, 0, page_tr.y()));
+  }
+}
+
+void BLOCK::scale_polygon(int factor, const ICOORD &page_tr) {
+  const TBOX box = pdblk.box;
+  ScalePoints(factor, box, page_tr, &pdblk.leftside);
+  ScalePoints(factor, box, page_tr, &pdblk.rightside);
+  if (pdblk.poly_block() != nullptr) {
+    ScalePoints(factor, box, page_tr, pdblk.poly_block()->points());
+    pdblk.poly_block()->compute_bb();
+    pdblk.box = *pdblk.poly_block()->bounding_box();
+  } else {
+    TBOX scaled(box.left() * factor, box.bottom() * factor,
+                box.right() * factor + factor - 1, box.top() * factor + factor - 1);
+    pdblk.box = scaled.intersection(TBOX(ICOORD(0, 0), page_tr));
+  }
+  median_size_ *= factor;
+}
+
 // Returns the bounding box including the desired combination of upper and
 // lower noise/diacritic elements.
 TBOX BLOCK::restricted_bounding_box(bool upper_dots, bool lower_dots) const {
@@ -166,6 +166,13 @@ public:
 
   void rotate(const FCOORD &rotation);
 
+  // Scales the polygon, side lists and median size up by factor, as for a
+  // block found on an image reduced by factor. Vertices on the right and
+  // top grow by factor - 1 more to cover the pixels the reduction merged.
+  // Clips the polygon to the page from the origin to page_tr and recomputes
+  // the bounding_box. Does nothing to any contained rows/words/blobs etc.
+  void scale_polygon(int factor, const ICOORD &page_tr);
+
   /// decreasing y order
   void sort_rows();
 
@@ -21,6 +21,8 @@
 
 #include "image.h"
 
+#include <tesseract/export.h> // for TESS_API
+
 #include <vector> // for std::vector
 
 struct Pix;
@@ -37,6 +39,7 @@ const int kHistogramSize = 256; // The size of a histogram of pixel values.
 // that there is no apparent foreground. At least one hi_value will not be -1.
 // The return value is the number of channels in the input image, being
 // the size of the output thresholds and hi_values arrays.
+TESS_API
 int OtsuThreshold(Image src_pix, int left, int top, int width, int height,
                   std::vector<int> &thresholds,
                   std::vector<int> &hi_values);
@@ -45,9 +48,17 @@ int OtsuThreshold(Image src_pix, int left, int top, int width, int height,
 // single channel. Each channel is always one byte per pixel.
 // Histogram is always a kHistogramSize(256) element array to count
 // occurrences of each pixel value.
+TESS_API
 void HistogramRect(Image src_pix, int channel, int left, int top, int width, int height,
                    int *histogram);
 
+// Computes the histograms of all channels for the given image rectangle in
+// a single pass over the image. histograms must have room for
+// kHistogramSize elements per channel, channel after channel.
+TESS_API
+void HistogramRectChannels(Image src_pix, int left, int top, int width, int height,
+                           int *histograms);
+
 // Computes the Otsu threshold(s) for the given histogram.
 // Also returns H = total count in histogram, and
 // omega0 = count of histogram below threshold.
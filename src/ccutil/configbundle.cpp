@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////////////
+// File:        configbundle.cpp
+// Description: Precompiled set of named parameter config files.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "configbundle.h"
+
+#include "helpers.h"  // for chomp_string
+#include "host.h"     // for MAX_PATH
+#include "serialis.h" // for TFile
+#include "tprintf.h"
+
+#include <cmath>   // for std::isnan
+#include <locale>  // for std::locale::classic
+#include <sstream> // for std::stringstream
+
+namespace tesseract {
+
+// "TCFB" in a little endian file.
+static const uint32_t kConfigBundleMagic = 0x42464354;
+static const uint32_t kConfigBundleVersion = 1;
+
+// Parses value as a number in the classic locale, like ParamUtils::SetParam,
+// but rejects anything that is not entirely a number.
+template <typename T>
+static bool ParseNumber(const char *value, T *result) {
+  std::stringstream stream(value);
+  stream.imbue(std::locale::classic());
+  stream >> *result;
+  if (stream.fail()) {
+    return false;
+  }
+  stream >> std::ws;
+  return stream.eof();
+}
+
+// Parses value as a bool the way ParamUtils::SetParam does.
+static bool ParseBool(const char *value, int32_t *result) {
+  if (*value == 'T' || *value == 't' || *value == 'Y' || *value == 'y' || *value == '1') {
+    *result = 1;
+  } else if (*value == 'F' || *value == 'f' || *value == 'N' || *value == 'n' || *value == '0') {
+    *result = 0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool ConfigBundle::AddConfig(const std::string &name, TFile *fp,
+                             const ParamsVectors *member_params) {
+  Config config;
+  config.name = name;
+  bool anyerr = false;
+  char line[MAX_PATH];
+  for (int line_num = 1; fp->FGets(line, MAX_PATH) != nullptr; ++line_num) {
+    if (line[0] == '\r' || line[0] == '\n' || line[0] == '#') {
+      continue;
+    }
+    chomp_string(line);
+    char *valptr = line;
+    while (*valptr && *valptr != ' ' && *valptr != '\t') {
+      ++valptr;
+    }
+    if (*valptr) {
+      *valptr = '\0';
+      do {
+        ++valptr;
+      } while (*valptr == ' ' || *valptr == '\t');
+    }
+    const ParamsVectors *global = GlobalParams();
+    bool found = false;
+    bool valid = true;
+    Entry entry;
+    entry.name = line;
+    if (ParamUtils::FindParam<StringParam>(line, global->string_params,
+                                           member_params->string_params) != nullptr) {
+      found = true;
+      entry.type = PT_STRING;
+      entry.string_value = valptr;
+      config.entries.push_back(entry);
+    }
+    // As in ParamUtils::SetParam, an empty value only applies to strings.
+    if (*valptr != '\0') {
+      if (ParamUtils::FindParam<IntParam>(line, global->int_params,
+                                          member_params->int_params) != nullptr) {
+        found = true;
+        entry.type = PT_INT;
+        valid = valid && ParseNumber(valptr, &entry.int_value);
+        config.entries.push_back(entry);
+      }
+      if (ParamUtils::FindParam<BoolParam>(line, global->bool_params,
+                                           member_params->bool_params) != nullptr) {
+        found = true;
+        entry.type = PT_BOOL;
+        valid = valid && ParseBool(valptr, &entry.int_value);
+        config.entries.push_back(entry);
+      }
+      if (ParamUtils::FindParam<DoubleParam>(line, global->double_params,
+                                             member_params->double_params) != nullptr) {
+        found = true;
+        entry.type = PT_DOUBLE;
+        valid = valid && ParseNumber(valptr, &entry.double_value) &&
+                !std::isnan(entry.double_value);
+        config.entries.push_back(entry);
+      }
+    }
+    if (!found) {
+      tprintf("Error: %s:%d: Unknown parameter: %s\n", name.c_str(), line_num, line);
+      anyerr = true;
+    } else if (!valid) {
+      tprintf("Error: %s:%d: Invalid value for %s: %s\n", name.c_str(), line_num, line,
+              valptr);
+      anyerr = true;
+    }
+  }
+  if (anyerr) {
+    return false;
+  }
+  for (auto &existing : configs_) {
+    if (existing.name == name) {
+      existing = std::move(config);
+      return true;
+    }
+  }
+  configs_.push_back(std::move(config));
+  return true;
+}
+
+const ConfigBundle::Config *ConfigBundle::FindConfig(const std::string &name) const {
+  for (const auto &config : configs_) {
+    if (config.name == name) {
+      return &config;
+    }
+  }
+  return nullptr;
+}
+
+bool ConfigBundle::Resolve(ParamsVectors *member_params) {
+  ParamsVectors *global = GlobalParams();
+  bool anyerr = false;
+  for (auto &config : configs_) {
+    for (auto &entry : config.entries) {
+      const char *param_name = entry.name.c_str();
+      switch (entry.type) {
+        case PT_INT:
+          entry.param = ParamUtils::FindParam<IntParam>(param_name, global->int_params,
+                                                        member_params->int_params);
+          break;
+        case PT_BOOL:
+          entry.param = ParamUtils::FindParam<BoolParam>(param_name, global->bool_params,
+                                                         member_params->bool_params);
+          break;
+        case PT_DOUBLE:
+          entry.param = ParamUtils::FindParam<DoubleParam>(
+              param_name, global->double_params, member_params->double_params);
+          break;
+        default:
+          entry.param = ParamUtils::FindParam<StringParam>(
+              param_name, global->string_params, member_params->string_params);
+          break;
+      }
+      if (entry.param == nullptr) {
+        tprintf("Warning: %s: Parameter not found: %s\n", config.name.c_str(), param_name);
+        anyerr = true;
+      }
+    }
+  }
+  return !anyerr;
+}
+
+bool ConfigBundle::Apply(const std::string &name, SetParamConstraint constraint) const {
+  const Config *config = FindConfig(name);
+  if (config == nullptr) {
+    return false;
+  }
+  bool anyerr = false;
+  for (const auto &entry : config->entries) {
+    if (entry.param == nullptr) {
+      anyerr = true;
+      continue;
+    }
+    if (!entry.param->constraint_ok(constraint)) {
+      continue;
+    }
+    switch (entry.type) {
+      case PT_INT:
+        static_cast<IntParam *>(entry.param)->set_value(entry.int_value);
+        break;
+      case PT_BOOL:
+        static_cast<BoolParam *>(entry.param)->set_value(entry.int_value != 0);
+        break;
+      case PT_DOUBLE:
+        static_cast<DoubleParam *>(entry.param)->set_value(entry.double_value);
+        break;
+      default:
+        static_cast<StringParam *>(entry.param)->set_value(entry.string_value);
+        break;
+    }
+  }
+  return !anyerr;
+}
+
+bool ConfigBundle::Serialize(TFile *fp) const {
+  uint32_t num_configs = configs_.size();
+  if (!fp->Serialize(&kConfigBundleMagic) || !fp->Serialize(&kConfigBundleVersion) ||
+      !fp->Serialize(&num_configs)) {
+    return false;
+  }
+  for (const auto &config : configs_) {
+    uint32_t num_entries = config.entries.size();
+    if (!fp->Serialize(config.name) || !fp->Serialize(&num_entries)) {
+      return false;
+    }
+    for (const auto &entry : config.entries) {
+      uint8_t type = entry.type;
+      if (!fp->Serialize(&type) || !fp->Serialize(entry.name)) {
+        return false;
+      }
+      bool ok = true;
+      switch (entry.type) {
+        case PT_INT:
+        case PT_BOOL:
+          ok = fp->Serialize(&entry.int_value);
+          break;
+        case PT_DOUBLE:
+          ok = fp->Serialize(&entry.double_value);
+          break;
+        default:
+          ok = fp->Serialize(entry.string_value);
+          break;
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ConfigBundle::DeSerialize(TFile *fp) {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_configs;
+  if (!fp->DeSerialize(&magic) || magic != kConfigBundleMagic) {
+    tprintf("Error: Not a config bundle\n");
+    return false;
+  }
+  if (!fp->DeSerialize(&version) || version != kConfigBundleVersion) {
+    tprintf("Error: Unsupported config bundle version\n");
+    return false;
+  }
+  // Each config and entry takes at least 4 bytes, which limits the counts
+  // that can be valid before allocating anything for them.
+  if (!fp->DeSerialize(&num_configs) || num_configs > fp->RemainingBytes() / 4) {
+    return false;
+  }
+  std::vector<Config> configs(num_configs);
+  for (auto &config : configs) {
+    uint32_t num_entries;
+    if (!fp->DeSerialize(config.name) || !fp->DeSerialize(&num_entries) ||
+        num_entries > fp->RemainingBytes() / 4) {
+      return false;
+    }
+    config.entries.resize(num_entries);
+    for (auto &entry : config.entries) {
+      uint8_t type;
+      if (!fp->DeSerialize(&type) || type >= PT_COUNT || !fp->DeSerialize(entry.name)) {
+        return false;
+      }
+      entry.type = static_cast<ParamType>(type);
+      bool ok = true;
+      switch (entry.type) {
+        case PT_INT:
+        case PT_BOOL:
+          ok = fp->DeSerialize(&entry.int_value);
+          break;
+        case PT_DOUBLE:
+          ok = fp->DeSerialize(&entry.double_value);
+          break;
+        default:
+          ok = fp->DeSerialize(entry.string_value);
+          break;
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+  }
+  configs_ = std::move(configs);
+  return true;
+}
+
+} // namespace tesseract
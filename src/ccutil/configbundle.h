@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////
+// File:        configbundle.h
+// Description: Precompiled set of named parameter config files.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_CONFIGBUNDLE_H_
+#define TESSERACT_CCUTIL_CONFIGBUNDLE_H_
+
+#include "params.h" // for Param, ParamsVectors, SetParamConstraint
+
+#include <cstdint> // for int32_t
+#include <string>
+#include <vector>
+
+namespace tesseract {
+
+class TFile;
+
+// A set of named config files (such as "hocr", "pdf" or "txt") whose
+// parameter names have already been resolved to a type and whose values
+// have already been parsed. It is built once from the text configs by
+// combine_tessdata, stored in the config-bundle component of a traineddata
+// file and applied at Init without touching the filesystem or parsing text.
+class TESS_API ConfigBundle {
+public:
+  ConfigBundle() = default;
+
+  bool empty() const {
+    return configs_.empty();
+  }
+  void Clear() {
+    configs_.clear();
+  }
+
+  // Parses the text config in fp in the format of
+  // ParamUtils::ReadParamsFromFp and adds it under the given name, replacing
+  // any config of the same name. Every parameter name must be known to
+  // either GlobalParams() or member_params and every value must parse as the
+  // type of the parameter, otherwise the problems are reported and false is
+  // returned without adding anything.
+  bool AddConfig(const std::string &name, TFile *fp, const ParamsVectors *member_params);
+
+  // Returns true if a config of the given name is present.
+  bool HasConfig(const std::string &name) const {
+    return FindConfig(name) != nullptr;
+  }
+
+  // Looks up the parameter of every entry in GlobalParams() and
+  // member_params once, so that Apply can set it without a search by name.
+  // member_params must outlive the bundle or the next call to Resolve.
+  // Returns false if one of the parameters no longer exists.
+  bool Resolve(ParamsVectors *member_params);
+
+  // Sets the parameters of the named config that satisfy the constraint.
+  // Returns false if the config is not present or one of its parameters
+  // was not found by Resolve.
+  bool Apply(const std::string &name, SetParamConstraint constraint) const;
+
+  // Writes to the given file. Returns false in case of error.
+  bool Serialize(TFile *fp) const;
+  // Reads from the given file, replacing the current contents. The whole
+  // bundle is validated before anything is replaced.
+  // Returns false in case of error.
+  bool DeSerialize(TFile *fp);
+
+private:
+  enum ParamType : uint8_t {
+    PT_INT,
+    PT_BOOL,
+    PT_DOUBLE,
+    PT_STRING,
+    PT_COUNT
+  };
+  struct Entry {
+    ParamType type;
+    std::string name;
+    // Value for PT_INT and PT_BOOL.
+    int32_t int_value = 0;
+    double double_value = 0.0;
+    std::string string_value;
+    // The parameter found by Resolve, of the class given by type.
+    Param *param = nullptr;
+  };
+  struct Config {
+    std::string name;
+    std::vector<Entry> entries;
+  };
+
+  const Config *FindConfig(const std::string &name) const;
+
+  std::vector<Config> configs_;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_CCUTIL_CONFIGBUNDLE_H_
@@ -52,6 +52,7 @@ static const char kLSTMNumberDawgFileSuffix[] = "lstm-number-dawg";
 static const char kLSTMUnicharsetFileSuffix[] = "lstm-unicharset";
 static const char kLSTMRecoderFileSuffix[] = "lstm-recoder";
 static const char kVersionFileSuffix[] = "version";
+static const char kConfigBundleFileSuffix[] = "config-bundle";
 
 namespace tesseract {
 
@@ -80,6 +81,7 @@ enum TessdataType {
   TESSDATA_LSTM_UNICHARSET,    // 21
   TESSDATA_LSTM_RECODER,       // 22
   TESSDATA_VERSION,            // 23
+  TESSDATA_CONFIG_BUNDLE,      // 24
 
   TESSDATA_NUM_ENTRIES
 };
@@ -113,6 +115,7 @@ static const char *const kTessdataFileSuffixes[] = {
     kLSTMUnicharsetFileSuffix,   // 21
     kLSTMRecoderFileSuffix,      // 22
     kVersionFileSuffix,          // 23
+    kConfigBundleFileSuffix,     // 24
 };
 
 /**
@@ -20,66 +20,199 @@
 
 #include <tesseract/unichar.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace tesseract {
 
-UNICHARMAP::UNICHARMAP() : nodes(nullptr) {}
+// Initial number of slots in the hash table. Must be a power of 2.
+const unsigned kInitialTableSize = 64;
+// Number of codepoints covered by each page of codepoint_pages_.
+const int kCodepointPageBits = 8;
+const int kCodepointPageSize = 1 << kCodepointPageBits;
 
-UNICHARMAP::~UNICHARMAP() {
-  delete[] nodes;
+UNICHARMAP::UNICHARMAP() : size_(0), max_length_(0) {
+  std::fill_n(single_byte_ids_, 256, INVALID_UNICHAR_ID);
 }
 
-// Search the given unichar representation in the tree, using length characters
-// from it maximum. Each character in the string is interpreted as an index in
-// an array of nodes.
-UNICHAR_ID UNICHARMAP::unichar_to_id(const char *const unichar_repr, int length) const {
-  UNICHARMAP_NODE *current_nodes = nodes;
+UNICHARMAP::~UNICHARMAP() = default;
+
+// Returns the number of characters of unichar_repr to use, ie length or the
+// position of the terminating null if that comes first.
+static int ReprLength(const char *const unichar_repr, int length) {
+  int repr_length = 0;
+  while (repr_length < length && unichar_repr[repr_length] != '\0') {
+    ++repr_length;
+  }
+  return repr_length;
+}
+
+// Returns the codepoint if the given representation of 2 to 4 bytes is
+// exactly one well-formed (shortest form) UTF-8 sequence, otherwise -1.
+static int DecodeCodepoint(const char *unichar_repr, int length) {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(unichar_repr);
+  int codepoint;
+  switch (length) {
+    case 2:
+      if ((bytes[0] & 0xe0) != 0xc0 || (bytes[1] & 0xc0) != 0x80) {
+        return -1;
+      }
+      codepoint = ((bytes[0] & 0x1f) << 6) | (bytes[1] & 0x3f);
+      return codepoint >= 0x80 ? codepoint : -1;
+    case 3:
+      if ((bytes[0] & 0xf0) != 0xe0 || ((bytes[1] & 0xc0) | ((bytes[2] & 0xc0) >> 2)) != 0xa0) {
+        return -1;
+      }
+      codepoint = ((bytes[0] & 0x0f) << 12) | ((bytes[1] & 0x3f) << 6) | (bytes[2] & 0x3f);
+      return codepoint >= 0x800 ? codepoint : -1;
+    case 4:
+      if ((bytes[0] & 0xf8) != 0xf0 ||
+          ((bytes[1] & 0xc0) | ((bytes[2] & 0xc0) >> 2) | ((bytes[3] & 0xc0) >> 4)) != 0xa8) {
+        return -1;
+      }
+      codepoint = ((bytes[0] & 0x07) << 18) | ((bytes[1] & 0x3f) << 12) |
+                  ((bytes[2] & 0x3f) << 6) | (bytes[3] & 0x3f);
+      return codepoint >= 0x10000 && codepoint <= 0x10ffff ? codepoint : -1;
+    default:
+      return -1;
+  }
+}
+
+// FNV-1a hash of a representation.
+static uint32_t HashRepr(const char *unichar_repr, int length) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(unichar_repr[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
 
+unsigned UNICHARMAP::FindSlot(const char *unichar_repr, int length, uint32_t hash) const {
+  unsigned mask = table_.size() - 1;
+  unsigned index = hash & mask;
+  while (table_[index].id != INVALID_UNICHAR_ID) {
+    const UNICHARMAP_ENTRY &entry = table_[index];
+    if (entry.hash == hash && entry.length == static_cast<uint32_t>(length) &&
+        memcmp(chars_.data() + entry.offset, unichar_repr, length) == 0) {
+      return index;
+    }
+    index = (index + 1) & mask;
+  }
+  return index;
+}
+
+void UNICHARMAP::Grow() {
+  std::vector<UNICHARMAP_ENTRY> old_table;
+  old_table.swap(table_);
+  table_.resize(old_table.empty() ? kInitialTableSize : 2 * old_table.size(),
+                UNICHARMAP_ENTRY{0, INVALID_UNICHAR_ID, 0, 0});
+  unsigned mask = table_.size() - 1;
+  for (const auto &entry : old_table) {
+    if (entry.id != INVALID_UNICHAR_ID) {
+      unsigned index = entry.hash & mask;
+      while (table_[index].id != INVALID_UNICHAR_ID) {
+        index = (index + 1) & mask;
+      }
+      table_[index] = entry;
+    }
+  }
+}
+
+inline UNICHAR_ID UNICHARMAP::Lookup(const char *unichar_repr, int length) const {
+  if (length == 1) {
+    return single_byte_ids_[static_cast<unsigned char>(*unichar_repr)];
+  }
+  if (length > max_length_) {
+    return INVALID_UNICHAR_ID;
+  }
+  if (length <= 4) {
+    int codepoint = DecodeCodepoint(unichar_repr, length);
+    if (codepoint >= 0) {
+      unsigned page = codepoint >> kCodepointPageBits;
+      if (page >= codepoint_pages_.size() || codepoint_pages_[page] == nullptr) {
+        return INVALID_UNICHAR_ID;
+      }
+      return codepoint_pages_[page][codepoint & (kCodepointPageSize - 1)];
+    }
+  }
+  if (table_.empty()) {
+    return INVALID_UNICHAR_ID;
+  }
+  return table_[FindSlot(unichar_repr, length, HashRepr(unichar_repr, length))].id;
+}
+
+// Search the given unichar representation, using length characters from it
+// maximum.
+UNICHAR_ID UNICHARMAP::unichar_to_id(const char *const unichar_repr, int length) const {
   assert(*unichar_repr != '\0');
   assert(length > 0 && length <= UNICHAR_LEN);
 
-  int index = 0;
-  if (length <= 0 || unichar_repr[index] == '\0') {
-    return INVALID_UNICHAR_ID;
+  auto lead = static_cast<unsigned char>(*unichar_repr);
+  if (length == 1 || unichar_repr[1] == '\0') {
+    return single_byte_ids_[lead];
   }
-  do {
-    if (index + 1 >= length || unichar_repr[index + 1] == '\0') {
-      return current_nodes[static_cast<unsigned char>(unichar_repr[index])].id;
+  // Fast path for a single multibyte codepoint, whose length is given by the
+  // lead byte. No more than the sequence and the byte after it are read, and
+  // none past length or a terminating null.
+  int step = lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+  if (ReprLength(unichar_repr, std::min(length, step + 1)) == step) {
+    int codepoint = DecodeCodepoint(unichar_repr, step);
+    if (codepoint >= 0) {
+      unsigned page = codepoint >> kCodepointPageBits;
+      if (page >= codepoint_pages_.size() || codepoint_pages_[page] == nullptr) {
+        return INVALID_UNICHAR_ID;
+      }
+      return codepoint_pages_[page][codepoint & (kCodepointPageSize - 1)];
     }
-    current_nodes = current_nodes[static_cast<unsigned char>(unichar_repr[index])].children;
-    ++index;
-  } while (true);
+  }
+  return Lookup(unichar_repr, ReprLength(unichar_repr, length));
 }
 
-// Search the given unichar representation in the tree, creating the possibly
-// missing nodes. Once the right place has been found, insert the given id and
-// update the inserted flag to keep track of the insert. Each character in the
-// string is interpreted as an index in an array of nodes.
+// Insert the given id for the whole of the given unichar representation,
+// replacing any id it already had.
 void UNICHARMAP::insert(const char *const unichar_repr, UNICHAR_ID id) {
-  const char *current_char = unichar_repr;
-  if (*current_char == '\0') {
+  int length = strlen(unichar_repr);
+  if (length == 0 || id == INVALID_UNICHAR_ID) {
+    return;
+  }
+  if (length == 1) {
+    single_byte_ids_[static_cast<unsigned char>(*unichar_repr)] = id;
     return;
   }
-  UNICHARMAP_NODE **current_nodes_pointer = &nodes;
-  do {
-    if (*current_nodes_pointer == nullptr) {
-      *current_nodes_pointer = new UNICHARMAP_NODE[256];
+  max_length_ = std::max(max_length_, length);
+  int codepoint = length <= 4 ? DecodeCodepoint(unichar_repr, length) : -1;
+  if (codepoint >= 0) {
+    unsigned page = codepoint >> kCodepointPageBits;
+    if (page >= codepoint_pages_.size()) {
+      codepoint_pages_.resize(page + 1);
     }
-    if (current_char[1] == '\0') {
-      (*current_nodes_pointer)[static_cast<unsigned char>(*current_char)].id = id;
-      return;
+    if (codepoint_pages_[page] == nullptr) {
+      codepoint_pages_[page].reset(new UNICHAR_ID[kCodepointPageSize]);
+      std::fill_n(codepoint_pages_[page].get(), kCodepointPageSize, INVALID_UNICHAR_ID);
     }
-    current_nodes_pointer =
-        &((*current_nodes_pointer)[static_cast<unsigned char>(*current_char)].children);
-    ++current_char;
-  } while (true);
+    codepoint_pages_[page][codepoint & (kCodepointPageSize - 1)] = id;
+    return;
+  }
+  // Keep the hash table at most half full.
+  if (2 * (size_ + 1) > static_cast<int>(table_.size())) {
+    Grow();
+  }
+  uint32_t hash = HashRepr(unichar_repr, length);
+  UNICHARMAP_ENTRY &entry = table_[FindSlot(unichar_repr, length, hash)];
+  if (entry.id == INVALID_UNICHAR_ID) {
+    entry.hash = hash;
+    entry.offset = chars_.size();
+    entry.length = length;
+    chars_.append(unichar_repr, length);
+    ++size_;
+  }
+  entry.id = id;
 }
 
-// Search the given unichar representation in the tree, using length characters
-// from it maximum. Each character in the string is interpreted as an index in
-// an array of nodes. Stop once the tree does not have anymore nodes or once we
-// found the right unichar_repr.
+// Search the given unichar representation, using length characters from it
+// maximum.
 bool UNICHARMAP::contains(const char *const unichar_repr, int length) const {
   if (unichar_repr == nullptr || *unichar_repr == '\0') {
     return false;
@@ -87,49 +220,28 @@ bool UNICHARMAP::contains(const char *const unichar_repr, int length) const {
   if (length <= 0 || length > UNICHAR_LEN) {
     return false;
   }
-  int index = 0;
-  if (unichar_repr[index] == '\0') {
-    return false;
-  }
-  UNICHARMAP_NODE *current_nodes = nodes;
-
-  while (current_nodes != nullptr && index + 1 < length && unichar_repr[index + 1] != '\0') {
-    current_nodes = current_nodes[static_cast<unsigned char>(unichar_repr[index])].children;
-    ++index;
-  }
-  return current_nodes != nullptr && (index + 1 >= length || unichar_repr[index + 1] == '\0') &&
-         current_nodes[static_cast<unsigned char>(unichar_repr[index])].id >= 0;
+  return unichar_to_id(unichar_repr, length) >= 0;
 }
 
 // Return the minimum number of characters that must be used from this string
 // to obtain a match in the UNICHARMAP.
 int UNICHARMAP::minmatch(const char *const unichar_repr) const {
-  const char *current_char = unichar_repr;
-  if (*current_char == '\0') {
-    return 0;
-  }
-  UNICHARMAP_NODE *current_nodes = nodes;
-
-  while (current_nodes != nullptr && *current_char != '\0') {
-    if (current_nodes[static_cast<unsigned char>(*current_char)].id >= 0) {
-      return current_char + 1 - unichar_repr;
+  int max_length = std::max(max_length_, 1);
+  for (int length = 1; length <= max_length && unichar_repr[length - 1] != '\0'; ++length) {
+    if (Lookup(unichar_repr, length) >= 0) {
+      return length;
     }
-    current_nodes = current_nodes[static_cast<unsigned char>(*current_char)].children;
-    ++current_char;
   }
   return 0;
 }
 
 void UNICHARMAP::clear() {
-  delete[] nodes;
-  nodes = nullptr;
-}
-
-UNICHARMAP::UNICHARMAP_NODE::UNICHARMAP_NODE() : children(nullptr), id(-1) {}
-
-// Recursively delete the children
-UNICHARMAP::UNICHARMAP_NODE::~UNICHARMAP_NODE() {
-  delete[] children;
+  std::fill_n(single_byte_ids_, 256, INVALID_UNICHAR_ID);
+  std::vector<std::unique_ptr<UNICHAR_ID[]>>().swap(codepoint_pages_);
+  std::vector<UNICHARMAP_ENTRY>().swap(table_);
+  std::string().swap(chars_);
+  size_ = 0;
+  max_length_ = 0;
 }
 
 } // namespace tesseract
@@ -22,6 +22,11 @@
 
 #include <tesseract/unichar.h>
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace tesseract {
 
 // A UNICHARMAP stores unique unichars. Each of them is associated with one
@@ -37,8 +42,8 @@ public:
   // with the given id. The length of the representation MUST be non-zero.
   void insert(const char *const unichar_repr, UNICHAR_ID id);
 
-  // Return the id associated with the given unichar representation,
-  // this representation MUST exist within the UNICHARMAP. The first
+  // Return the id associated with the given unichar representation, or
+  // INVALID_UNICHAR_ID if it is not present in the UNICHARMAP. The first
   // length characters (maximum) from unichar_repr are used. The length
   // MUST be non-zero.
   UNICHAR_ID unichar_to_id(const char *const unichar_repr, int length) const;
@@ -56,17 +61,33 @@ public:
   void clear();
 
 private:
-  // The UNICHARMAP is represented as a tree whose nodes are of type
-  // UNICHARMAP_NODE.
-  struct UNICHARMAP_NODE {
-    UNICHARMAP_NODE();
-    ~UNICHARMAP_NODE();
-
-    UNICHARMAP_NODE *children;
-    UNICHAR_ID id;
+  // Representations that are a single codepoint are looked up directly:
+  // single bytes (which is all of ASCII) in single_byte_ids_, and longer
+  // UTF-8 sequences in codepoint_pages_, a table of 256-entry pages indexed by
+  // codepoint that are only allocated where the unicharset has members.
+  // Everything else (ligatures and grapheme clusters) is stored in chars_ and
+  // found through table_, an open-addressed hash table with linear probing.
+  struct UNICHARMAP_ENTRY {
+    uint32_t hash;
+    UNICHAR_ID id; // INVALID_UNICHAR_ID for an empty slot.
+    uint32_t offset;
+    uint32_t length;
   };
 
-  UNICHARMAP_NODE *nodes;
+  // Returns the index of the slot holding the given representation, or of the
+  // empty slot where it would be inserted.
+  unsigned FindSlot(const char *unichar_repr, int length, uint32_t hash) const;
+  // Doubles the size of the hash table and reinserts all the entries.
+  void Grow();
+  // Returns the id of the given representation of the given exact length.
+  UNICHAR_ID Lookup(const char *unichar_repr, int length) const;
+
+  UNICHAR_ID single_byte_ids_[256];
+  std::vector<std::unique_ptr<UNICHAR_ID[]>> codepoint_pages_;
+  std::vector<UNICHARMAP_ENTRY> table_;
+  std::string chars_;
+  int size_;
+  int max_length_;
 };
 
 } // namespace tesseract
@@ -186,9 +186,10 @@ UNICHAR_ID
 UNICHARSET::unichar_to_id(const char *const unichar_repr) const {
   std::string cleaned =
       old_style_included_ ? unichar_repr : CleanupString(unichar_repr);
-  return ids.contains(cleaned.data(), cleaned.size())
-             ? ids.unichar_to_id(cleaned.data(), cleaned.size())
-             : INVALID_UNICHAR_ID;
+  if (cleaned.empty() || cleaned.size() > UNICHAR_LEN) {
+    return INVALID_UNICHAR_ID;
+  }
+  return ids.unichar_to_id(cleaned.data(), cleaned.size());
 }
 
 UNICHAR_ID UNICHARSET::unichar_to_id(const char *const unichar_repr,
@@ -198,9 +199,10 @@ UNICHAR_ID UNICHARSET::unichar_to_id(const char *const unichar_repr,
   if (!old_style_included_) {
     cleaned = CleanupString(unichar_repr, length);
   }
-  return ids.contains(cleaned.data(), cleaned.size())
-             ? ids.unichar_to_id(cleaned.data(), cleaned.size())
-             : INVALID_UNICHAR_ID;
+  if (cleaned.empty() || cleaned.size() > UNICHAR_LEN) {
+    return INVALID_UNICHAR_ID;
+  }
+  return ids.unichar_to_id(cleaned.data(), cleaned.size());
 }
 
 // Return the minimum number of bytes that matches a legal UNICHAR_ID,
@@ -513,9 +515,9 @@ void UNICHARSET::encode_string(const char *str, int str_index, int str_length,
     return;
   }
   do {
-    if (ids.contains(str + str_index, length)) {
+    UNICHAR_ID id = ids.unichar_to_id(str + str_index, length);
+    if (id != INVALID_UNICHAR_ID) {
       // Successful encoding so far.
-      UNICHAR_ID id = ids.unichar_to_id(str + str_index, length);
       encoding->push_back(id);
       lengths->push_back(length);
       encode_string(str, str_index + length, str_length, encoding, lengths,
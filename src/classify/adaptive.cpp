@@ -19,8 +19,11 @@
 
 #include "classify.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 
 namespace tesseract {
 
@@ -245,6 +248,92 @@ ADAPT_TEMPLATES_STRUCT *Classify::ReadAdaptedTemplates(TFile *fp) {
 
 } /* ReadAdaptedTemplates */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * Read a set of adapted templates from file as ReadAdaptedTemplates
+ * does, but into scratch font tables, so that templates can be loaded
+ * while this classifier is in use. The templates are only returned if
+ * they were learned with the same unicharset and fonts as this.
+ *
+ * @param fp open file to read adapted templates from
+ * @return Ptr to adapted templates read from file, or nullptr.
+ */
+ADAPT_TEMPLATES_STRUCT *Classify::ReadCompatibleAdaptedTemplates(TFile *fp) {
+  if (fp->RemainingBytes() < sizeof(ADAPT_TEMPLATES_STRUCT)) {
+    return nullptr;
+  }
+  auto Templates = new ADAPT_TEMPLATES_STRUCT;
+  fp->FRead(Templates, sizeof(ADAPT_TEMPLATES_STRUCT), 1);
+
+  int font_table_version;
+  Templates->Templates = ReadIntTemplates(fp, &font_table_version);
+  UnicityTable<FontInfo> fontinfo_table;
+  using namespace std::placeholders; // for _1
+  fontinfo_table.set_clear_callback(std::bind(FontInfoDeleteCallback, _1));
+  UnicityTable<FontSet> fontset_table;
+  ReadFontTables(fp, font_table_version, &fontinfo_table, &fontset_table);
+
+  for (unsigned i = 0; i < (Templates->Templates)->NumClasses; i++) {
+    Templates->Class[i] = ReadAdaptedClass(fp);
+  }
+
+  // Adapted configs refer to unichar ids and font ids, so both must agree.
+  bool compatible = Templates->Templates->NumClasses == unicharset.size() &&
+                    fontinfo_table.size() == fontinfo_table_.size();
+  for (int i = 0; compatible && i < fontinfo_table.size(); ++i) {
+    compatible = strcmp(fontinfo_table.at(i).name, fontinfo_table_.at(i).name) == 0;
+  }
+  if (!compatible) {
+    delete Templates;
+    return nullptr;
+  }
+  return (Templates);
+
+} /* ReadCompatibleAdaptedTemplates */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * Move the adapted classes of src that are still empty in
+ * AdaptedTemplates over to AdaptedTemplates, together with their
+ * class pruner bits. Classes that were already adapted are kept.
+ *
+ * @param src adapted templates to merge, deleted afterwards
+ */
+void Classify::MergeAdaptedTemplates(ADAPT_TEMPLATES_STRUCT *src) {
+  INT_TEMPLATES_STRUCT *dst_int = AdaptedTemplates->Templates;
+  INT_TEMPLATES_STRUCT *src_int = src->Templates;
+  auto num_classes = std::min(dst_int->NumClasses, src_int->NumClasses);
+  for (unsigned id = 0; id < num_classes; id++) {
+    if (!IsEmptyAdaptedClass(AdaptedTemplates->Class[id]) || IsEmptyAdaptedClass(src->Class[id])) {
+      continue;
+    }
+    std::swap(AdaptedTemplates->Class[id], src->Class[id]);
+    std::swap(ClassForClassId(dst_int, id), ClassForClassId(src_int, id));
+
+    CLASS_PRUNER_STRUCT *dst_pruner = CPrunerFor(dst_int, id);
+    const CLASS_PRUNER_STRUCT *src_pruner = CPrunerFor(src_int, id);
+    int word = CPrunerWordIndexFor(id);
+    uint32_t mask = CLASS_PRUNER_CLASS_MASK << (CPrunerBitIndexFor(id) * NUM_BITS_PER_CLASS);
+    for (int x = 0; x < NUM_CP_BUCKETS; x++) {
+      for (int y = 0; y < NUM_CP_BUCKETS; y++) {
+        for (int z = 0; z < NUM_CP_BUCKETS; z++) {
+          uint32_t &bits = dst_pruner->p[x][y][z][word];
+          bits = (bits & ~mask) | (src_pruner->p[x][y][z][word] & mask);
+        }
+      }
+    }
+
+    AdaptedTemplates->NumNonEmptyClasses++;
+    if (AdaptedTemplates->Class[id]->NumPermConfigs > 0) {
+      AdaptedTemplates->NumPermClasses++;
+    }
+    if (CharNormCutoffs != nullptr) {
+      BaselineCutoffs[id] = CharNormCutoffs[id];
+    }
+  }
+  delete src;
+} /* MergeAdaptedTemplates */
+
 /*---------------------------------------------------------------------------*/
 /**
  * Read a permanent configuration description from file
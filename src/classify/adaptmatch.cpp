@@ -53,6 +53,7 @@
 #include "shapeclassifier.h" // for ShapeClassifier
 #include "shapetable.h"      // for UnicharRating, ShapeTable, Shape, Uni...
 #include "tessclassifier.h"  // for TessClassifier
+#include "templatecache.h"   // for StaticTemplates, TemplateCache
 #include "tessdatamanager.h" // for TessdataManager, TESSDATA_INTTEMP
 #include "tprintf.h"         // for tprintf
 #include "trainingsample.h"  // for TrainingSample
@@ -485,12 +486,15 @@ void Classify::EndAdaptiveClassifier() {
   delete BackupAdaptedTemplates;
   BackupAdaptedTemplates = nullptr;
 
-  if (PreTrainedTemplates != nullptr) {
-    delete PreTrainedTemplates;
-    PreTrainedTemplates = nullptr;
+  if (static_templates_ != nullptr) {
+    GlobalTemplateCache()->FreeTemplates(static_templates_);
+    static_templates_ = nullptr;
   }
+  PreTrainedTemplates = nullptr;
+  NormProtos = nullptr;
+  shape_table_ = nullptr;
+  CharNormCutoffs = nullptr;
   getDict().EndDangerousAmbigs();
-  FreeNormProtos();
   if (AllProtosOn != nullptr) {
     FreeBitVector(AllProtosOn);
     FreeBitVector(AllConfigsOn);
@@ -501,12 +505,60 @@ void Classify::EndAdaptiveClassifier() {
     AllConfigsOff = nullptr;
     TempProtoMask = nullptr;
   }
-  delete shape_table_;
-  shape_table_ = nullptr;
   delete static_classifier_;
   static_classifier_ = nullptr;
 } /* EndAdaptiveClassifier */
 
+// Writes AdaptedTemplates to basename + ADAPT_TEMPLATE_SUFFIX, so that a
+// later job can start from what has been learned so far.
+bool Classify::SaveAdaptedTemplatesTo(const std::string &basename) {
+  if (AdaptedTemplates == nullptr) {
+    return false;
+  }
+  std::string filename = basename + ADAPT_TEMPLATE_SUFFIX;
+  FILE *File = fopen(filename.c_str(), "wb");
+  if (File == nullptr) {
+    tprintf("Unable to save adapted templates to %s!\n", filename.c_str());
+    return false;
+  }
+  WriteAdaptedTemplates(File, AdaptedTemplates);
+  return fclose(File) == 0;
+}
+
+// Reads adapted templates from basename + ADAPT_TEMPLATE_SUFFIX and either
+// merges them into or replaces AdaptedTemplates.
+bool Classify::LoadAdaptedTemplatesFrom(const std::string &basename, bool merge) {
+  if (AdaptedTemplates == nullptr) {
+    return false;
+  }
+  std::string filename = basename + ADAPT_TEMPLATE_SUFFIX;
+  TFile fp;
+  if (!fp.Open(filename.c_str(), nullptr)) {
+    return false;
+  }
+  ADAPT_TEMPLATES_STRUCT *templates = ReadCompatibleAdaptedTemplates(&fp);
+  if (templates == nullptr) {
+    tprintf("Adapted templates in %s don't match the loaded traineddata!\n", filename.c_str());
+    return false;
+  }
+  if (classify_learning_debug_level > 0) {
+    tprintf("%s adapted templates from %s\n", merge ? "Merging" : "Loading", filename.c_str());
+  }
+  if (merge) {
+    MergeAdaptedTemplates(templates);
+  } else {
+    delete AdaptedTemplates;
+    AdaptedTemplates = templates;
+    NumAdaptationsFailed = 0;
+    if (CharNormCutoffs != nullptr) {
+      for (unsigned i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
+        BaselineCutoffs[i] = CharNormCutoffs[i];
+      }
+    }
+  }
+  return true;
+}
+
 /*---------------------------------------------------------------------------*/
 /**
  * This routine reads in the training
@@ -535,24 +587,29 @@ void Classify::InitAdaptiveClassifier(TessdataManager *mgr) {
   // If there is no language_data_path_prefix, the classifier will be
   // adaptive only.
   if (language_data_path_prefix.length() > 0 && mgr != nullptr) {
-    TFile fp;
-    ASSERT_HOST(mgr->GetComponent(TESSDATA_INTTEMP, &fp));
-    PreTrainedTemplates = ReadIntTemplates(&fp);
-
-    if (mgr->GetComponent(TESSDATA_SHAPE_TABLE, &fp)) {
-      shape_table_ = new ShapeTable(unicharset);
-      if (!shape_table_->DeSerialize(&fp)) {
-        tprintf("Error loading shape table!\n");
-        delete shape_table_;
-        shape_table_ = nullptr;
-      }
+    // The static templates are the same for every instance that uses this
+    // traineddata, so they are loaded once and shared through the cache.
+    std::string id = mgr->GetDataFileName() + kTessdataFileSuffixes[TESSDATA_INTTEMP] + ":" +
+                     std::to_string(unicharset.size());
+    bool loaded = false;
+    static_templates_ = GlobalTemplateCache()->GetTemplates(id, [this, mgr, &loaded]() {
+      loaded = true;
+      return LoadStaticTemplates(mgr);
+    });
+    ASSERT_HOST(static_templates_ != nullptr);
+    if (!loaded) {
+      // The font tables are per instance, so read them from where they
+      // follow the shared int templates.
+      TFile fp;
+      ASSERT_HOST(mgr->GetComponent(TESSDATA_INTTEMP, &fp));
+      ASSERT_HOST(fp.Skip(static_templates_->font_table_offset));
+      ReadFontTables(&fp, static_templates_->font_table_version, &fontinfo_table_,
+                     &fontset_table_);
     }
-
-    ASSERT_HOST(mgr->GetComponent(TESSDATA_PFFMTABLE, &fp));
-    ReadNewCutoffs(&fp, CharNormCutoffs);
-
-    ASSERT_HOST(mgr->GetComponent(TESSDATA_NORMPROTO, &fp));
-    NormProtos = ReadNormProtos(&fp);
+    PreTrainedTemplates = static_templates_->int_templates;
+    shape_table_ = static_templates_->shape_table;
+    NormProtos = static_templates_->norm_protos;
+    CharNormCutoffs = static_templates_->char_norm_cutoffs;
     static_classifier_ = new TessClassifier(false, this);
   }
 
@@ -583,8 +640,10 @@ void Classify::InitAdaptiveClassifier(TessdataManager *mgr) {
       tprintf("\n");
       PrintAdaptedTemplates(stdout, AdaptedTemplates);
 
-      for (unsigned i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
-        BaselineCutoffs[i] = CharNormCutoffs[i];
+      if (CharNormCutoffs != nullptr) {
+        for (unsigned i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
+          BaselineCutoffs[i] = CharNormCutoffs[i];
+        }
       }
     }
   } else {
@@ -593,6 +652,41 @@ void Classify::InitAdaptiveClassifier(TessdataManager *mgr) {
   }
 } /* InitAdaptiveClassifier */
 
+// Reads the static classifier components of mgr into new StaticTemplates.
+// The font tables that follow the int templates are read into this.
+StaticTemplates *Classify::LoadStaticTemplates(TessdataManager *mgr) {
+  auto *templates = new StaticTemplates;
+  templates->unicharset.CopyFrom(unicharset);
+
+  TFile fp;
+  ASSERT_HOST(mgr->GetComponent(TESSDATA_INTTEMP, &fp));
+  size_t inttemp_size = fp.RemainingBytes();
+  templates->int_templates = ReadIntTemplates(&fp, &templates->font_table_version);
+  templates->font_table_offset = inttemp_size - fp.RemainingBytes();
+  ReadFontTables(&fp, templates->font_table_version, &fontinfo_table_, &fontset_table_);
+
+  if (mgr->GetComponent(TESSDATA_SHAPE_TABLE, &fp)) {
+    templates->shape_table = new ShapeTable(templates->unicharset);
+    if (!templates->shape_table->DeSerialize(&fp)) {
+      tprintf("Error loading shape table!\n");
+      delete templates->shape_table;
+      templates->shape_table = nullptr;
+    } else {
+      // NumFonts caches its result, so compute it now while no other
+      // instance can be reading the table.
+      templates->shape_table->NumFonts();
+    }
+  }
+
+  ASSERT_HOST(mgr->GetComponent(TESSDATA_PFFMTABLE, &fp));
+  ReadNewCutoffs(&fp, templates->shape_table != nullptr ? &templates->shapetable_cutoffs : nullptr,
+                 templates->char_norm_cutoffs);
+
+  ASSERT_HOST(mgr->GetComponent(TESSDATA_NORMPROTO, &fp));
+  templates->norm_protos = ReadNormProtos(&fp);
+  return templates;
+}
+
 void Classify::ResetAdaptiveClassifierInternal() {
   if (classify_learning_debug_level > 0) {
     tprintf("Resetting adaptive classifier (NumAdaptationsFailed=%d)\n", NumAdaptationsFailed);
@@ -706,7 +800,7 @@ void Classify::InitAdaptedClass(TBLOB *Blob, CLASS_ID ClassId, int FontinfoId, A
 
   /* this is a kludge to construct cutoffs for adapted templates */
   if (Templates == AdaptedTemplates) {
-    BaselineCutoffs[ClassId] = CharNormCutoffs[ClassId];
+    BaselineCutoffs[ClassId] = CharNormCutoffs != nullptr ? CharNormCutoffs[ClassId] : 0;
   }
 
   IClass = ClassForClassId(Templates->Templates, ClassId);
@@ -1308,7 +1402,7 @@ int Classify::CharNormTrainingSample(bool pruner_only, int keep_this, const Trai
   ComputeCharNormArrays(norm_feature, PreTrainedTemplates, &char_norm_array[0], &pruner_norm_array[0]);
 
   PruneClasses(PreTrainedTemplates, num_features, keep_this, sample.features(), &pruner_norm_array[0],
-               shape_table_ != nullptr ? &shapetable_cutoffs_[0] : CharNormCutoffs,
+               shape_table_ != nullptr ? &static_templates_->shapetable_cutoffs[0] : CharNormCutoffs,
                &adapt_results->CPResults);
   if (keep_this >= 0) {
     adapt_results->CPResults[0].Class = keep_this;
@@ -54,6 +54,7 @@ Classify::~Classify() {}
 #  include "scrollview.h"
 #  include "shapeclassifier.h"
 #  include "shapetable.h"
+#  include "templatecache.h"
 #  include "unicity_table.h"
 
 namespace tesseract {
@@ -77,6 +78,9 @@ Classify::Classify()
                   this->params())
     , BOOL_MEMBER(classify_save_adapted_templates, 0, "Save adapted templates to a file",
                   this->params())
+    , STRING_MEMBER(classify_adapted_templates_dir, "",
+                    "Directory of the adapted templates saved and loaded by document class",
+                    this->params())
     , BOOL_MEMBER(classify_enable_adaptive_debugger, 0, "Enable match debugger", this->params())
     , BOOL_MEMBER(classify_nonlinear_norm, 0, "Non-linear stroke-density normalization",
                   this->params())
@@ -156,6 +160,13 @@ Classify::~Classify() {
 #endif
 }
 
+TemplateCache *Classify::GlobalTemplateCache() {
+  // Like Dict::GlobalDawgCache, this singleton outlives every Tesseract
+  // instance.
+  static TemplateCache cache;
+  return &cache;
+}
+
 // Takes ownership of the given classifier, and uses it for future calls
 // to CharNormClassifier.
 void Classify::SetStaticClassifier(ShapeClassifier *static_classifier) {
@@ -80,6 +80,8 @@ static const int kBlankFontinfoId = -2;
 class ShapeClassifier;
 struct ShapeRating;
 class ShapeTable;
+struct StaticTemplates;
+class TemplateCache;
 struct UnicharRating;
 
 // How segmented is a blob. In this enum, character refers to a classifiable
@@ -103,6 +105,10 @@ public:
     return shape_table_;
   }
 
+  // Returns the process-wide cache of static classifier templates, which
+  // lets every instance using the same traineddata share one copy.
+  static TemplateCache *GlobalTemplateCache();
+
   // Takes ownership of the given classifier, and uses it for future calls
   // to CharNormClassifier.
   void SetStaticClassifier(ShapeClassifier *static_classifier);
@@ -133,13 +139,19 @@ public:
   int PruneClasses(const INT_TEMPLATES_STRUCT *int_templates, int num_features, int keep_this,
                    const INT_FEATURE_STRUCT *features, const uint8_t *normalization_factors,
                    const uint16_t *expected_num_features, std::vector<CP_RESULT_STRUCT> *results);
-  void ReadNewCutoffs(TFile *fp, uint16_t *Cutoffs);
+  void ReadNewCutoffs(TFile *fp, std::vector<uint16_t> *shapetable_cutoffs, uint16_t *Cutoffs);
   void PrintAdaptedTemplates(FILE *File, ADAPT_TEMPLATES_STRUCT *Templates);
   void WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES_STRUCT *Templates);
   ADAPT_TEMPLATES_STRUCT *ReadAdaptedTemplates(TFile *File);
+  // As ReadAdaptedTemplates, but leaves the font tables of this untouched.
+  // Returns nullptr if the templates were not learned with the same
+  // unicharset and fonts as this classifier.
+  ADAPT_TEMPLATES_STRUCT *ReadCompatibleAdaptedTemplates(TFile *fp);
+  // Moves every class that is adapted in src but still empty in
+  // AdaptedTemplates over to AdaptedTemplates, then deletes src.
+  void MergeAdaptedTemplates(ADAPT_TEMPLATES_STRUCT *src);
   /* normmatch.cpp ************************************************************/
   float ComputeNormMatch(CLASS_ID ClassId, const FEATURE_STRUCT &feature, bool DebugMatch);
-  void FreeNormProtos();
   NORM_PROTOS *ReadNormProtos(TFile *fp);
   /* protos.cpp ***************************************************************/
   void ConvertProto(PROTO_STRUCT *Proto, int ProtoId, INT_CLASS_STRUCT *Class);
@@ -243,6 +255,13 @@ public:
   void DisplayAdaptedChar(TBLOB *blob, INT_CLASS_STRUCT *int_class);
   bool AdaptableWord(WERD_RES *word);
   void EndAdaptiveClassifier();
+  // Writes AdaptedTemplates to basename + ".a". Returns false on failure.
+  bool SaveAdaptedTemplatesTo(const std::string &basename);
+  // Reads adapted templates from basename + ".a". If merge is true, they
+  // fill in the classes that have not been adapted yet, otherwise they
+  // replace AdaptedTemplates. Returns false if the file is missing or was
+  // written for a different unicharset or font table.
+  bool LoadAdaptedTemplatesFrom(const std::string &basename, bool merge);
   void SetupPass1();
   void SetupPass2();
   void AdaptiveClassifier(TBLOB *Blob, BLOB_CHOICE_LIST *Choices);
@@ -315,7 +334,13 @@ public:
   void ComputeIntCharNormArray(const FEATURE_STRUCT &norm_feature, uint8_t *char_norm_array);
   void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY &IntFeatures);
   /* intproto.cpp *************************************************************/
-  INT_TEMPLATES_STRUCT *ReadIntTemplates(TFile *fp);
+  // Reads int templates from fp, followed by the font tables. If
+  // font_table_version is not nullptr, the font tables are left unread and
+  // their format version is returned instead, for use with ReadFontTables.
+  INT_TEMPLATES_STRUCT *ReadIntTemplates(TFile *fp, int *font_table_version = nullptr);
+  // Reads the fontinfo and fontset tables that follow the int templates.
+  static void ReadFontTables(TFile *fp, int version_id, UnicityTable<FontInfo> *fontinfo_table,
+                             UnicityTable<FontSet> *fontset_table);
   void WriteIntTemplates(FILE *File, INT_TEMPLATES_STRUCT *Templates, const UNICHARSET &target_unicharset);
   CLASS_ID GetClassToDebug(const char *Prompt, bool *adaptive_on, bool *pretrained_on,
                            int *shape_id);
@@ -377,6 +402,7 @@ public:
   BOOL_VAR_H(classify_enable_adaptive_matcher);
   BOOL_VAR_H(classify_use_pre_adapted_templates);
   BOOL_VAR_H(classify_save_adapted_templates);
+  STRING_VAR_H(classify_adapted_templates_dir);
   BOOL_VAR_H(classify_enable_adaptive_debugger);
   BOOL_VAR_H(classify_nonlinear_norm);
   INT_VAR_H(matcher_debug_level);
@@ -416,6 +442,8 @@ public:
   double_VAR_H(speckle_rating_penalty);
 
   // Use class variables to hold onto built-in templates and adapted templates.
+  // The built-in templates belong to static_templates_ and must not be
+  // modified, as they are shared with other instances.
   INT_TEMPLATES_STRUCT *PreTrainedTemplates = nullptr;
   ADAPT_TEMPLATES_STRUCT *AdaptedTemplates = nullptr;
   // The backup adapted templates are created from the previous page (only)
@@ -451,6 +479,13 @@ protected:
   ShapeTable *shape_table_ = nullptr;
 
 private:
+  // Reads the static classifier components of mgr into new StaticTemplates.
+  // The font tables that follow the int templates are read into this.
+  StaticTemplates *LoadStaticTemplates(TessdataManager *mgr);
+
+  // The shared static templates that PreTrainedTemplates, NormProtos,
+  // shape_table_ and CharNormCutoffs point into, or nullptr.
+  StaticTemplates *static_templates_ = nullptr;
   // The currently active static classifier.
   ShapeClassifier *static_classifier_ = nullptr;
 #ifndef GRAPHICS_DISABLED
@@ -464,8 +499,6 @@ private:
 
   Dict dict_;
 
-  std::vector<uint16_t> shapetable_cutoffs_;
-
   /* variables used to hold performance statistics */
   int NumAdaptationsFailed = 0;
 
@@ -475,9 +508,10 @@ private:
   // CharNormCutoffs is for the static classifier (with no shapetable).
   // BaselineCutoffs gets a copy of CharNormCutoffs as an estimate of the real
   // value in the adaptive classifier. Both are indexed by unichar_id.
-  // shapetable_cutoffs_ provides a similar value for each shape in the
-  // shape_table_
-  uint16_t CharNormCutoffs[MAX_NUM_CLASSES] = {};
+  // static_templates_->shapetable_cutoffs provides a similar value for each
+  // shape in the shape_table_. CharNormCutoffs is nullptr without
+  // static_templates_.
+  const uint16_t *CharNormCutoffs = nullptr;
   uint16_t BaselineCutoffs[MAX_NUM_CLASSES];
 
 public:
@@ -36,13 +36,16 @@ namespace tesseract {
  * indexed in the array by class id.  Unused entries in the
  * array are set to an arbitrarily high cutoff value.
  * @param fp file containing cutoff definitions
+ * @param shapetable_cutoffs per shape cutoffs, which precede the class
+ *        cutoffs when there is a shape table, otherwise nullptr
  * @param Cutoffs array to put cutoffs into
  */
-void Classify::ReadNewCutoffs(TFile *fp, uint16_t *Cutoffs) {
+void Classify::ReadNewCutoffs(TFile *fp, std::vector<uint16_t> *shapetable_cutoffs,
+                              uint16_t *Cutoffs) {
   int Cutoff;
 
-  if (shape_table_ != nullptr) {
-    if (!fp->DeSerialize(shapetable_cutoffs_)) {
+  if (shapetable_cutoffs != nullptr) {
+    if (!fp->DeSerialize(*shapetable_cutoffs)) {
       tprintf("Error during read of shapetable pffmtable!\n");
     }
   }
@@ -627,10 +627,12 @@ INT_TEMPLATES_STRUCT::~INT_TEMPLATES_STRUCT() {
  * File.  File must already be open and must be in the
  * correct binary format.
  * @param  fp open file to read templates from
+ * @param  font_table_version if not nullptr, receives the format version
+ *         of the font tables, which are then left unread
  * @return Pointer to integer templates read from File.
  * @note Globals: none
  */
-INT_TEMPLATES_STRUCT *Classify::ReadIntTemplates(TFile *fp) {
+INT_TEMPLATES_STRUCT *Classify::ReadIntTemplates(TFile *fp, int *font_table_version) {
   int j, w, x, y, z;
   INT_TEMPLATES_STRUCT *Templates;
   CLASS_PRUNER_STRUCT *Pruner;
@@ -848,17 +850,35 @@ INT_TEMPLATES_STRUCT *Classify::ReadIntTemplates(TFile *fp) {
       }
     }
   }
+  if (font_table_version != nullptr) {
+    *font_table_version = version_id;
+  } else {
+    ReadFontTables(fp, version_id, &fontinfo_table_, &fontset_table_);
+  }
+
+  return (Templates);
+} /* ReadIntTemplates */
+
+/**
+ * This routine reads the fontinfo and fontset tables that follow
+ * the integer templates in an inttemp file written with the given
+ * version_id. Older versions have no font tables.
+ * @param fp open file positioned at the start of the font tables
+ * @param version_id format version of the inttemp file
+ * @param fontinfo_table table to read the font info into
+ * @param fontset_table table to read the font sets into
+ */
+void Classify::ReadFontTables(TFile *fp, int version_id, UnicityTable<FontInfo> *fontinfo_table,
+                              UnicityTable<FontSet> *fontset_table) {
   if (version_id >= 4) {
     using namespace std::placeholders; // for _1, _2
-    this->fontinfo_table_.read(fp, std::bind(read_info, _1, _2));
+    fontinfo_table->read(fp, std::bind(read_info, _1, _2));
     if (version_id >= 5) {
-      this->fontinfo_table_.read(fp, std::bind(read_spacing_info, _1, _2));
+      fontinfo_table->read(fp, std::bind(read_spacing_info, _1, _2));
     }
-    this->fontset_table_.read(fp, [](auto *f, auto *fs) { return f->DeSerialize(*fs); } );
+    fontset_table->read(fp, [](auto *f, auto *fs) { return f->DeSerialize(*fs); } );
   }
-
-  return (Templates);
-} /* ReadIntTemplates */
+} /* ReadFontTables */
 
 #ifndef GRAPHICS_DISABLED
 /**
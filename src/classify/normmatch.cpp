@@ -152,14 +152,13 @@ float Classify::ComputeNormMatch(CLASS_ID ClassId, const FEATURE_STRUCT &feature
   return 1 - NormEvidenceOf(BestMatch);
 } /* ComputeNormMatch */
 
-void Classify::FreeNormProtos() {
-  if (NormProtos != nullptr) {
-    for (int i = 0; i < NormProtos->NumProtos; i++) {
-      FreeProtoList(&NormProtos->Protos[i]);
+void FreeNormProtos(NORM_PROTOS *norm_protos) {
+  if (norm_protos != nullptr) {
+    for (int i = 0; i < norm_protos->NumProtos; i++) {
+      FreeProtoList(&norm_protos->Protos[i]);
     }
-    delete[] NormProtos->ParamDesc;
-    delete NormProtos;
-    NormProtos = nullptr;
+    delete[] norm_protos->ParamDesc;
+    delete norm_protos;
   }
 }
 
@@ -24,10 +24,15 @@
 
 namespace tesseract {
 
+struct NORM_PROTOS;
+
 /* control knobs used to control the normalization adjustment process */
 extern double_VAR_H(classify_norm_adj_midpoint);
 extern double_VAR_H(classify_norm_adj_curl);
 
+// Deletes norm_protos, as returned by Classify::ReadNormProtos.
+void FreeNormProtos(NORM_PROTOS *norm_protos);
+
 } // namespace tesseract
 
 #endif
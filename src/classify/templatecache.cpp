@@ -0,0 +1,31 @@
+///////////////////////////////////////////////////////////////////////
+// File:        templatecache.cpp
+// Description: Shared, reference counted static classifier templates.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "templatecache.h"
+
+#include "intproto.h"   // for INT_TEMPLATES_STRUCT
+#include "normmatch.h"  // for FreeNormProtos
+#include "shapetable.h" // for ShapeTable
+
+namespace tesseract {
+
+StaticTemplates::~StaticTemplates() {
+  delete int_templates;
+  delete shape_table;
+  FreeNormProtos(norm_protos);
+}
+
+} // namespace tesseract
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////
+// File:        templatecache.h
+// Description: Shared, reference counted static classifier templates.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_TEMPLATECACHE_H_
+#define TESSERACT_CLASSIFY_TEMPLATECACHE_H_
+
+#include "matchdefs.h"    // for MAX_NUM_CLASSES
+#include "object_cache.h" // for ObjectCache
+#include "unicharset.h"   // for UNICHARSET
+
+#include <cstdint>    // for uint16_t
+#include <functional> // for std::function
+#include <string>
+#include <vector>
+
+namespace tesseract {
+
+struct INT_TEMPLATES_STRUCT;
+struct NORM_PROTOS;
+class ShapeTable;
+
+// The pre-trained part of the legacy classifier, built from the inttemp,
+// shapetable, pffmtable and normproto components of a traineddata file.
+// Nothing in it is modified after loading, so all Classify instances that
+// use the same traineddata share one copy. The adapted templates stay with
+// each Classify.
+struct StaticTemplates {
+  StaticTemplates() = default;
+  ~StaticTemplates();
+  StaticTemplates(const StaticTemplates &) = delete;
+  StaticTemplates &operator=(const StaticTemplates &) = delete;
+
+  // Private copy of the unicharset for shape_table, so that the shape table
+  // does not depend on the lifetime of the Classify that loaded it.
+  UNICHARSET unicharset;
+  INT_TEMPLATES_STRUCT *int_templates = nullptr;
+  ShapeTable *shape_table = nullptr;
+  NORM_PROTOS *norm_protos = nullptr;
+  // Expected number of features for each unichar_id (char_norm_cutoffs)
+  // or, if there is a shape table, for each shape (shapetable_cutoffs).
+  uint16_t char_norm_cutoffs[MAX_NUM_CLASSES] = {};
+  std::vector<uint16_t> shapetable_cutoffs;
+  // The font tables that follow the templates in the inttemp component
+  // belong to each Classify, so record where they start and their version.
+  int font_table_version = 0;
+  size_t font_table_offset = 0;
+};
+
+class TemplateCache {
+public:
+  // Returns the templates identified by id, calling loader to read them
+  // if no other instance holds them yet. Every successful call must be
+  // matched by a call to FreeTemplates.
+  StaticTemplates *GetTemplates(const std::string &id,
+                                std::function<StaticTemplates *()> loader) {
+    return templates_.Get(id, loader);
+  }
+
+  // Decrements the count of the given templates.
+  // If the templates are unknown to us, returns false.
+  bool FreeTemplates(StaticTemplates *templates) {
+    return templates_.Free(templates);
+  }
+
+  // Free up any currently unused templates.
+  void DeleteUnusedTemplates() {
+    templates_.DeleteUnusedObjects();
+  }
+
+private:
+  ObjectCache<StaticTemplates> templates_;
+};
+
+} // namespace tesseract
+
+#endif // TESSERACT_CLASSIFY_TEMPLATECACHE_H_
@@ -205,6 +205,17 @@ SquishedDawg::~SquishedDawg() {
   delete[] edges_;
 }
 
+bool SquishedDawg::IsSquishedDawgFile(const char *filename) {
+  FILE *fp = fopen(filename, "rb");
+  if (fp == nullptr) {
+    return false;
+  }
+  int16_t magic = 0;
+  bool is_dawg = fread(&magic, sizeof(magic), 1, fp) == 1 && magic == kDawgMagicNumber;
+  fclose(fp);
+  return is_dawg;
+}
+
 EDGE_REF SquishedDawg::edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
                                     bool word_end) const {
   EDGE_REF edge = node;
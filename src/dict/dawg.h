@@ -125,6 +125,9 @@ public:
   inline PermuterType permuter() const {
     return perm_;
   }
+  inline int unicharset_size() const {
+    return unicharset_size_;
+  }
 
   virtual ~Dawg();
 
@@ -427,6 +430,11 @@ public:
   }
   ~SquishedDawg() override;
 
+  /// Returns true if the named file starts with the squished dawg magic
+  /// number, ie it was compiled offline (eg by wordlist2dawg) rather than
+  /// being a plain text word list.
+  static bool IsSquishedDawgFile(const char *filename);
+
   // Loads using the given TFile. Returns false on failure.
   bool Load(TFile *fp) {
     if (!read_squished_dawg(fp)) {
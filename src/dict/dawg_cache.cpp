@@ -21,6 +21,9 @@
 #include "dawg.h"
 #include "object_cache.h"
 #include "tessdatamanager.h"
+#include "tprintf.h"
+
+#include <string>
 
 namespace tesseract {
 
@@ -48,6 +51,31 @@ Dawg *DawgCache::GetSquishedDawg(const std::string &lang, TessdataType tessdata_
   return dawgs_.Get(data_id, std::bind(&DawgLoader::Load, &loader));
 }
 
+Dawg *DawgCache::GetSquishedDawgFromFile(const std::string &lang, const std::string &filename,
+                                         DawgType dawg_type, PermuterType perm,
+                                         int unicharset_size, int debug_level) {
+  std::string data_id = filename;
+  data_id += ":" + std::to_string(perm) + ":" + std::to_string(unicharset_size);
+  return dawgs_.Get(data_id, [&]() -> Dawg * {
+    TFile fp;
+    if (!fp.Open(filename.c_str(), nullptr)) {
+      return nullptr;
+    }
+    auto *dawg = new SquishedDawg(dawg_type, lang, perm, debug_level);
+    if (!dawg->Load(&fp)) {
+      delete dawg;
+      return nullptr;
+    }
+    if (dawg->unicharset_size() != unicharset_size) {
+      tprintf("Error: dawg %s was built for a unicharset of size %d, not %d\n",
+              filename.c_str(), dawg->unicharset_size(), unicharset_size);
+      delete dawg;
+      return nullptr;
+    }
+    return dawg;
+  });
+}
+
 Dawg *DawgLoader::Load() {
   TFile fp;
   if (!data_file_->GetComponent(tessdata_dawg_type_, &fp)) {
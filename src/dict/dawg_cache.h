@@ -31,6 +31,15 @@ public:
   Dawg *GetSquishedDawg(const std::string &lang, TessdataType tessdata_dawg_type, int debug_level,
                         TessdataManager *data_file);
 
+  // Returns a SquishedDawg read from a precompiled dawg file (as written by
+  // wordlist2dawg). All callers that name the same file and permuter share
+  // one copy, so large user word lists are only loaded once per process.
+  // Returns nullptr if the file can't be read or was compiled against a
+  // unicharset of a different size.
+  Dawg *GetSquishedDawgFromFile(const std::string &lang, const std::string &filename,
+                                DawgType dawg_type, PermuterType perm, int unicharset_size,
+                                int debug_level);
+
   // If we manage the given dawg, decrement its count,
   // and possibly delete it if the count reaches zero.
   // If dawg is unknown to us, return false.
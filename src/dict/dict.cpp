@@ -242,42 +242,7 @@ void Dict::Load(const std::string &lang, TessdataManager *data_file) {
     }
   }
 
-  std::string name;
-  if (!user_words_suffix.empty() || !user_words_file.empty()) {
-    Trie *trie_ptr =
-        new Trie(DAWG_TYPE_WORD, lang, USER_DAWG_PERM, getUnicharset().size(), dawg_debug_level);
-    if (!user_words_file.empty()) {
-      name = user_words_file;
-    } else {
-      name = getCCUtil()->language_data_path_prefix;
-      name += user_words_suffix;
-    }
-    if (!trie_ptr->read_and_add_word_list(name.c_str(), getUnicharset(),
-                                          Trie::RRP_REVERSE_IF_HAS_RTL)) {
-      tprintf("Error: failed to load %s\n", name.c_str());
-      delete trie_ptr;
-    } else {
-      dawgs_.push_back(trie_ptr);
-    }
-  }
-
-  if (!user_patterns_suffix.empty() || !user_patterns_file.empty()) {
-    Trie *trie_ptr = new Trie(DAWG_TYPE_PATTERN, lang, USER_PATTERN_PERM, getUnicharset().size(),
-                              dawg_debug_level);
-    trie_ptr->initialize_patterns(&(getUnicharset()));
-    if (!user_patterns_file.empty()) {
-      name = user_patterns_file;
-    } else {
-      name = getCCUtil()->language_data_path_prefix;
-      name += user_patterns_suffix;
-    }
-    if (!trie_ptr->read_pattern_list(name.c_str(), getUnicharset())) {
-      tprintf("Error: failed to load %s\n", name.c_str());
-      delete trie_ptr;
-    } else {
-      dawgs_.push_back(trie_ptr);
-    }
-  }
+  LoadUserDawgs(lang);
 
   document_words_ =
       new Trie(DAWG_TYPE_WORD, lang, DOC_DAWG_PERM, getUnicharset().size(), dawg_debug_level);
@@ -313,27 +278,46 @@ void Dict::LoadLSTM(const std::string &lang, TessdataManager *data_file) {
     }
   }
 
-  // stolen from Dict::Load (but needs params_ from Tesseract
+  // Same as Dict::Load (but needs params_ from Tesseract
   // langdata/config/api):
+  LoadUserDawgs(lang);
+}
+
+// Loads the user words and user patterns named by the user_words_* and
+// user_patterns_* params. A user words file that was precompiled into a
+// squished dawg with wordlist2dawg is loaded through the dawg cache (and so
+// shared with other instances), otherwise it is read as a text word list.
+void Dict::LoadUserDawgs(const std::string &lang) {
   std::string name;
   if (!user_words_suffix.empty() || !user_words_file.empty()) {
-    Trie *trie_ptr =
-        new Trie(DAWG_TYPE_WORD, lang, USER_DAWG_PERM, getUnicharset().size(), dawg_debug_level);
     if (!user_words_file.empty()) {
       name = user_words_file;
     } else {
       name = getCCUtil()->language_data_path_prefix;
       name += user_words_suffix;
     }
-    if (!trie_ptr->read_and_add_word_list(name.c_str(), getUnicharset(),
-                                          Trie::RRP_REVERSE_IF_HAS_RTL)) {
-      tprintf("Error: failed to load %s\n", name.c_str());
-      delete trie_ptr;
+    if (SquishedDawg::IsSquishedDawgFile(name.c_str())) {
+      Dawg *user_dawg = dawg_cache_->GetSquishedDawgFromFile(
+          lang, name, DAWG_TYPE_WORD, USER_DAWG_PERM, getUnicharset().size(), dawg_debug_level);
+      if (user_dawg == nullptr) {
+        tprintf("Error: failed to load %s\n", name.c_str());
+      } else {
+        dawgs_.push_back(user_dawg);
+      }
     } else {
-      dawgs_.push_back(trie_ptr);
+      Trie *trie_ptr =
+          new Trie(DAWG_TYPE_WORD, lang, USER_DAWG_PERM, getUnicharset().size(), dawg_debug_level);
+      if (!trie_ptr->read_and_add_word_list(name.c_str(), getUnicharset(),
+                                            Trie::RRP_REVERSE_IF_HAS_RTL)) {
+        tprintf("Error: failed to load %s\n", name.c_str());
+        delete trie_ptr;
+      } else {
+        dawgs_.push_back(trie_ptr);
+      }
     }
   }
 
+  // Patterns rely on the Trie pattern edges, so they can't be squished.
   if (!user_patterns_suffix.empty() || !user_patterns_file.empty()) {
     Trie *trie_ptr = new Trie(DAWG_TYPE_PATTERN, lang, USER_PATTERN_PERM, getUnicharset().size(),
                               dawg_debug_level);
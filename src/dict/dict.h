@@ -471,6 +471,9 @@ public:
   bool IsSpaceDelimitedLang() const;
 
 private:
+  // Loads the user words and user patterns dawgs. Called by Load and LoadLSTM.
+  void LoadUserDawgs(const std::string &lang);
+
   /** Private member variables. */
   CCUtil *ccutil_;
   /**
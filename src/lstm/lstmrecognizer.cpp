@@ -30,6 +30,7 @@
 #include "input.h"
 #include "lstm.h"
 #include "normalis.h"
+#include "otsuthr.h"     // for HistogramRect, OtsuStats
 #include "pageres.h"
 #include "ratngs.h"
 #include "recodebeam.h"
@@ -62,6 +63,9 @@ LSTMRecognizer::LSTMRecognizer()
     , momentum_(0.0f)
     , adam_beta_(0.0f)
     , dict_(nullptr)
+    , use_dict_(true)
+    , predict_polarity_(false)
+    , narrow_beam_(false)
     , search_(nullptr)
     , debug_win_(nullptr) {}
 
@@ -258,6 +262,8 @@ void LSTMRecognizer::RecognizeLine(const ImageData &image_data,
   if (search_ == nullptr) {
     search_ = new RecodeBeamSearch(recoder_, null_char_, SimpleTextOutput(), dict_);
   }
+  search_->SetDict(use_dict_ ? dict_ : nullptr);
+  search_->SetNarrowBeam(narrow_beam_);
   search_->excludedUnichars.clear();
   search_->Decode(outputs, kDictRatio, kCertOffset, worst_dict_cert, &GetUnicharset(),
                   lstm_choice_mode);
@@ -315,6 +321,47 @@ void LSTMRecognizer::OutputStats(const NetworkIO &outputs, float *min_output, fl
   }
 }
 
+// Minimum difference between the mean grey values of the dark and light
+// pixels of a line for PredictPolarity to trust its histogram.
+const int kMinPolarityContrast = 48;
+// Text covers at most this fraction of the pixels of a line box, and its
+// background at least 1 - kMaxTextFraction.
+const double kMaxTextFraction = 0.35;
+
+// Predicts the polarity of an 8 bit line image from its grey histogram:
+// the text is the minority of the pixels, on whichever side of the Otsu
+// threshold that is, provided the two sides are clearly apart.
+LSTMRecognizer::LinePolarity LSTMRecognizer::PredictPolarity(Image pix) {
+  if (pixGetDepth(pix) != 8) {
+    return kPolarityAmbiguous;
+  }
+  int width = pixGetWidth(pix);
+  int height = pixGetHeight(pix);
+  int histogram[kHistogramSize];
+  HistogramRect(pix, 0, 0, 0, width, height, histogram);
+  int total, num_dark;
+  int threshold = OtsuStats(histogram, &total, &num_dark);
+  if (threshold < 0 || num_dark == 0 || num_dark == total) {
+    return kPolarityAmbiguous;
+  }
+  double dark_sum = 0.0, light_sum = 0.0;
+  for (int value = 0; value < kHistogramSize; ++value) {
+    (value <= threshold ? dark_sum : light_sum) += static_cast<double>(value) * histogram[value];
+  }
+  double contrast = light_sum / (total - num_dark) - dark_sum / num_dark;
+  if (contrast < kMinPolarityContrast) {
+    return kPolarityAmbiguous;
+  }
+  double dark_fraction = static_cast<double>(num_dark) / total;
+  if (dark_fraction <= kMaxTextFraction) {
+    return kPolarityNormal;
+  }
+  if (dark_fraction >= 1.0 - kMaxTextFraction) {
+    return kPolarityInverted;
+  }
+  return kPolarityAmbiguous;
+}
+
 // Recognizes the image_data, returning the labels,
 // scores, and corresponding pairs of start, end x-coords in coords.
 bool LSTMRecognizer::RecognizeLine(const ImageData &image_data,
@@ -339,18 +386,37 @@ bool LSTMRecognizer::RecognizeLine(const ImageData &image_data,
   if (upside_down) {
     pixRotate180(pix, pix);
   }
+  // Training needs the outputs of the original polarity, so it always
+  // starts with it.
+  bool inverted = false;
+  if (invert_threshold > 0.0f && !re_invert) {
+    LinePolarity polarity = predict_polarity_ ? PredictPolarity(pix) : kPolarityAmbiguous;
+    if (polarity == kPolarityInverted) {
+      ++polarity_counts_.inverted;
+      pixInvert(pix, pix);
+      inverted = true;
+    } else if (polarity == kPolarityNormal) {
+      ++polarity_counts_.normal;
+    } else {
+      ++polarity_counts_.ambiguous;
+    }
+  }
   // Reduction factor from image to coords.
   *scale_factor = min_width / *scale_factor;
   inputs->set_int_mode(IsIntMode());
   SetRandomSeed();
   Input::PreparePixInput(network_->InputShape(), pix, &randomizer_, inputs);
   network_->Forward(debug, *inputs, nullptr, &scratch_space_, outputs);
-  // Check for auto inversion.
+  // Check for auto inversion. A predicted polarity only decides which way
+  // is tried first.
   if (invert_threshold > 0.0f) {
     float pos_min, pos_mean, pos_sd;
     OutputStats(*outputs, &pos_min, &pos_mean, &pos_sd);
     if (pos_mean < invert_threshold) {
-      // Run again inverted and see if it is any better.
+      if (!re_invert) {
+        ++polarity_counts_.both_ways;
+      }
+      // Run again with the other polarity and see if it is any better.
       NetworkIO inv_inputs, inv_outputs;
       inv_inputs.set_int_mode(IsIntMode());
       SetRandomSeed();
@@ -359,8 +425,12 @@ bool LSTMRecognizer::RecognizeLine(const ImageData &image_data,
       network_->Forward(debug, inv_inputs, nullptr, &scratch_space_, &inv_outputs);
       float inv_min, inv_mean, inv_sd;
       OutputStats(inv_outputs, &inv_min, &inv_mean, &inv_sd);
+      // The second run saw the inverted line, unless the first one did.
+      if (!re_invert && (inv_mean > pos_mean) != inverted) {
+        ++polarity_counts_.both_ways_inverted;
+      }
       if (inv_mean > pos_mean) {
-        // Inverted did better. Use inverted data.
+        // The second run did better. Use its data.
         if (debug) {
           tprintf("Inverting image: old min=%g, mean=%g, sd=%g, inv %g,%g,%g\n", pos_min, pos_mean,
                   pos_sd, inv_min, inv_mean, inv_sd);
@@ -531,6 +601,7 @@ void LSTMRecognizer::LabelsViaReEncode(const NetworkIO &output, std::vector<int>
   if (search_ == nullptr) {
     search_ = new RecodeBeamSearch(recoder_, null_char_, SimpleTextOutput(), dict_);
   }
+  search_->SetDict(dict_);
   search_->Decode(output, 1.0, 0.0, RecodeBeamSearch::kMinCertainty, nullptr);
   search_->ExtractBestPathAsLabels(labels, xcoords);
 }
@@ -20,6 +20,7 @@
 
 #include "ccutil.h"
 #include "helpers.h"
+#include "image.h" // for Image
 #include "matrix.h"
 #include "network.h"
 #include "networkscratch.h"
@@ -46,6 +47,17 @@ enum TrainingFlags {
   TF_COMPRESS_UNICHARSET = 64,
 };
 
+// How often the polarity of a line was predicted from its grey values before
+// recognition, and how often the line had to be recognized both normal and
+// inverted to decide.
+struct PolarityCounts {
+  int normal = 0;            // Predicted dark text on a light background.
+  int inverted = 0;          // Predicted light text on a dark background.
+  int ambiguous = 0;         // No prediction, or prediction disabled.
+  int both_ways = 0;         // Recognized normal and inverted.
+  int both_ways_inverted = 0; // Of those, the inverted result was better.
+};
+
 // Top-level line recognizer class for LSTM-based networks.
 // Note that a sub-class, LSTMTrainer is used for training.
 class TESS_API LSTMRecognizer {
@@ -203,6 +215,22 @@ public:
   Dict *GetDict() {
     return dict_;
   }
+  // Makes RecognizeLine decode with the dictionary, if there is one, only
+  // if use_dict is true. Without it the beam search is faster.
+  void SetUseDict(bool use_dict) {
+    use_dict_ = use_dict;
+  }
+  // Makes RecognizeLine with an invert_threshold first try the polarity that
+  // PredictPolarity reads from the line image, instead of always the original
+  // one. The other polarity is still tried if the first scores below the
+  // invert_threshold.
+  void SetPredictPolarity(bool predict_polarity) {
+    predict_polarity_ = predict_polarity;
+  }
+  // Makes RecognizeLine decode with half the beam width if narrow_beam.
+  void SetNarrowBeam(bool narrow_beam) {
+    narrow_beam_ = narrow_beam;
+  }
   // Sets the sample iteration to the given value. The sample_iteration_
   // determines the seed for the random number generator. The training
   // iteration is incremented only by a successful training iteration.
@@ -267,6 +295,15 @@ public:
   bool RecognizeLine(const ImageData &image_data, float invert_threshold, bool debug, bool re_invert,
                      bool upside_down, float *scale_factor, NetworkIO *inputs, NetworkIO *outputs);
 
+  // Returns the counts of polarity decisions of RecognizeLine with an
+  // invert_threshold since the last ResetPolarityCounts.
+  const PolarityCounts &polarity_counts() const {
+    return polarity_counts_;
+  }
+  void ResetPolarityCounts() {
+    polarity_counts_ = PolarityCounts();
+  }
+
   // Converts an array of labels to utf-8, whether or not the labels are
   // augmented with character boundaries.
   std::string DecodeLabels(const std::vector<int> &labels);
@@ -284,6 +321,16 @@ public:
                          std::vector<int> *xcoords);
 
 protected:
+  enum LinePolarity {
+    kPolarityNormal,
+    kPolarityInverted,
+    kPolarityAmbiguous,
+  };
+
+  // Predicts from the grey values of the line image, as prepared for the
+  // network, whether it has dark text on a light background or the reverse.
+  static LinePolarity PredictPolarity(Image pix);
+
   // Sets the random seed from the sample_iteration_;
   void SetRandomSeed() {
     int64_t seed = sample_iteration_ * 0x10000001LL;
@@ -358,9 +405,18 @@ protected:
   NetworkScratch scratch_space_;
   // Language model (optional) to use with the beam search.
   Dict *dict_;
+  // Whether RecognizeLine decodes with dict_.
+  bool use_dict_;
+  // Whether RecognizeLine starts with the polarity from PredictPolarity.
+  bool predict_polarity_;
+  // Whether RecognizeLine decodes with half the beam width.
+  bool narrow_beam_;
   // Beam search held between uses to optimize memory allocation/use.
   RecodeBeamSearch *search_;
 
+  // Counts of the polarity decisions of RecognizeLine.
+  PolarityCounts polarity_counts_;
+
   // == Debugging parameters.==
   // Recognition debug display window.
   ScrollView *debug_win_;
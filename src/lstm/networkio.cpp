@@ -157,6 +157,41 @@ static void ComputeBlackWhite(Image pix, float *black, float *white) {
   *white = maxes.ile(0.75);
 }
 
+// Helper returns the pixel value with [black, black + 2*contrast] mapped to
+// [-1, 1].
+static float NormalizePixel(int pixel, float black, float contrast) {
+  return (pixel - black) / contrast - 1.0f;
+}
+
+// Helper returns a value from NormalizePixel quantized to (-127, 127).
+static int8_t QuantizePixel(float float_pixel) {
+  return ClipToRange<int>(IntCastRounded((INT8_MAX + 1) * float_pixel), -INT8_MAX, INT8_MAX);
+}
+
+// Table of the values that SetPixel would store for each 8 bit pixel value.
+// As black and contrast are fixed for a whole image, the images are copied
+// through the table instead of doing the float arithmetic for every pixel.
+class PixelTable {
+public:
+  PixelTable(float black, float contrast) {
+    for (int pixel = 0; pixel <= UINT8_MAX; ++pixel) {
+      floats_[pixel] = NormalizePixel(pixel, black, contrast);
+      ints_[pixel] = QuantizePixel(floats_[pixel]);
+    }
+  }
+
+  float float_value(int pixel) const {
+    return floats_[pixel];
+  }
+  int8_t int_value(int pixel) const {
+    return ints_[pixel];
+  }
+
+private:
+  float floats_[UINT8_MAX + 1];
+  int8_t ints_[UINT8_MAX + 1];
+};
+
 // Sets up the array from the given image, using the currently set int_mode_.
 // If the image width doesn't match the shape, the image is truncated or padded
 // with noise to match.
@@ -227,20 +262,30 @@ void NetworkIO::Copy2DImage(int batch, Image pix, float black, float contrast, T
   if (width > target_width) {
     width = target_width;
   }
+  PixelTable table(black, contrast);
   uint32_t *line = pixGetData(pix);
   for (int y = 0; y < target_height; ++y, line += wpl) {
     int x = 0;
     if (y < height) {
-      for (x = 0; x < width; ++x, ++t) {
-        if (color) {
+      if (color) {
+        for (x = 0; x < width; ++x, ++t) {
           int f = 0;
-          for (int c = COLOR_RED; c <= COLOR_BLUE; ++c) {
+          for (int c = COLOR_RED; c <= COLOR_BLUE; ++c, ++f) {
             int pixel = Image::getDataByte(line + x, c);
-            SetPixel(t, f++, pixel, black, contrast);
+            if (int_mode_) {
+              i_[t][f] = table.int_value(pixel);
+            } else {
+              f_[t][f] = table.float_value(pixel);
+            }
           }
-        } else {
-          int pixel = Image::getDataByte(line, x);
-          SetPixel(t, 0, pixel, black, contrast);
+        }
+      } else if (int_mode_) {
+        for (x = 0; x < width; ++x, ++t) {
+          i_[t][0] = table.int_value(Image::getDataByte(line, x));
+        }
+      } else {
+        for (x = 0; x < width; ++x, ++t) {
+          f_[t][0] = table.float_value(Image::getDataByte(line, x));
         }
       }
     }
@@ -267,12 +312,22 @@ void NetworkIO::Copy1DGreyImage(int batch, Image pix, float black, float contras
   if (width > target_width) {
     width = target_width;
   }
+  PixelTable table(black, contrast);
+  uint32_t *data = pixGetData(pix);
   int x;
   for (x = 0; x < width; ++x, ++t) {
-    for (int y = 0; y < height; ++y) {
-      uint32_t *line = pixGetData(pix) + wpl * y;
-      int pixel = Image::getDataByte(line, x);
-      SetPixel(t, y, pixel, black, contrast);
+    // The features of a timestep are contiguous, so fill them in one go.
+    uint32_t *line = data;
+    if (int_mode_) {
+      int8_t *features = i_[t];
+      for (int y = 0; y < height; ++y, line += wpl) {
+        features[y] = table.int_value(Image::getDataByte(line, x));
+      }
+    } else {
+      float *features = f_[t];
+      for (int y = 0; y < height; ++y, line += wpl) {
+        features[y] = table.float_value(Image::getDataByte(line, x));
+      }
     }
   }
   for (; x < target_width; ++x) {
@@ -288,9 +343,9 @@ void NetworkIO::Copy1DGreyImage(int batch, Image pix, float black, float contras
 // black: the pixel value to map to the lowest of the range of *this
 // contrast: the range of pixel values to stretch to half the range of *this.
 void NetworkIO::SetPixel(int t, int f, int pixel, float black, float contrast) {
-  float float_pixel = (pixel - black) / contrast - 1.0f;
+  float float_pixel = NormalizePixel(pixel, black, contrast);
   if (int_mode_) {
-    i_[t][f] = ClipToRange<int>(IntCastRounded((INT8_MAX + 1) * float_pixel), -INT8_MAX, INT8_MAX);
+    i_[t][f] = QuantizePixel(float_pixel);
   } else {
     f_[t][f] = float_pixel;
   }
@@ -65,12 +65,18 @@ RecodeBeamSearch::RecodeBeamSearch(const UnicharCompress &recoder,
       dict_(dict),
       space_delimited_(true),
       is_simple_text_(simple_text),
+      narrow_beam_(false),
       null_char_(null_char) {
   if (dict_ != nullptr && !dict_->IsSpaceDelimitedLang()) {
     space_delimited_ = false;
   }
 }
 
+void RecodeBeamSearch::SetDict(Dict *dict) {
+  dict_ = dict;
+  space_delimited_ = dict_ == nullptr || dict_->IsSpaceDelimitedLang();
+}
+
 RecodeBeamSearch::~RecodeBeamSearch() {
   for (auto data : beam_) {
     delete data;
@@ -90,7 +96,7 @@ void RecodeBeamSearch::Decode(const NetworkIO &output, double dict_ratio,
     timesteps.clear();
   }
   for (int t = 0; t < width; ++t) {
-    ComputeTopN(output.f(t), output.NumFeatures(), kBeamWidths[0]);
+    ComputeTopN(output.f(t), output.NumFeatures(), BeamWidth(0));
     DecodeStep(output.f(t), t, dict_ratio, cert_offset, worst_dict_cert,
                charset);
     if (lstm_choice_mode) {
@@ -105,7 +111,7 @@ void RecodeBeamSearch::Decode(const GENERIC_2D_ARRAY<float> &output,
   beam_size_ = 0;
   int width = output.dim1();
   for (int t = 0; t < width; ++t) {
-    ComputeTopN(output[t], output.dim2(), kBeamWidths[0]);
+    ComputeTopN(output[t], output.dim2(), BeamWidth(0));
     DecodeStep(output[t], t, dict_ratio, cert_offset, worst_dict_cert, charset);
   }
 }
@@ -128,7 +134,7 @@ void RecodeBeamSearch::DecodeSecondaryBeams(
       ++bucketNumber;
     }
     ComputeSecTopN(&(excludedUnichars)[bucketNumber], output.f(t),
-                   output.NumFeatures(), kBeamWidths[0]);
+                   output.NumFeatures(), BeamWidth(0));
     DecodeSecondaryStep(output.f(t), t, dict_ratio, cert_offset,
                         worst_dict_cert, charset);
   }
@@ -804,7 +810,7 @@ void RecodeBeamSearch::DecodeStep(const float *outputs, int t,
       if (step->best_initial_dawgs_[c].code >= 0) {
         int index = BeamIndex(true, static_cast<NodeContinuation>(c), 0);
         RecodeHeap *dawg_heap = &step->beams_[index];
-        PushHeapIfBetter(kBeamWidths[0], &step->best_initial_dawgs_[c],
+        PushHeapIfBetter(BeamWidth(0), &step->best_initial_dawgs_[c],
                          dawg_heap);
       }
     }
@@ -875,7 +881,7 @@ void RecodeBeamSearch::DecodeSecondaryStep(
       if (step->best_initial_dawgs_[c].code >= 0) {
         int index = BeamIndex(true, static_cast<NodeContinuation>(c), 0);
         RecodeHeap *dawg_heap = &step->beams_[index];
-        PushHeapIfBetter(kBeamWidths[0], &step->best_initial_dawgs_[c],
+        PushHeapIfBetter(BeamWidth(0), &step->best_initial_dawgs_[c],
                          dawg_heap);
       }
     }
@@ -1027,7 +1033,7 @@ void RecodeBeamSearch::ContinueUnichar(int code, int unichar_id, float cert,
     }
   } else {
     RecodeHeap *nodawg_heap = &step->beams_[BeamIndex(false, cont, 0)];
-    PushHeapIfBetter(kBeamWidths[0], code, unichar_id, TOP_CHOICE_PERM, false,
+    PushHeapIfBetter(BeamWidth(0), code, unichar_id, TOP_CHOICE_PERM, false,
                      false, false, false, cert * dict_ratio, prev, nullptr,
                      nodawg_heap);
     if (dict_ != nullptr &&
@@ -1067,7 +1073,7 @@ void RecodeBeamSearch::ContinueDawg(int code, int unichar_id, float cert,
   RecodeHeap *dawg_heap = &step->beams_[BeamIndex(true, cont, 0)];
   RecodeHeap *nodawg_heap = &step->beams_[BeamIndex(false, cont, 0)];
   if (unichar_id == INVALID_UNICHAR_ID) {
-    PushHeapIfBetter(kBeamWidths[0], code, unichar_id, NO_PERM, false, false,
+    PushHeapIfBetter(BeamWidth(0), code, unichar_id, NO_PERM, false, false,
                      false, false, cert, prev, nullptr, dawg_heap);
     return;
   }
@@ -1076,9 +1082,9 @@ void RecodeBeamSearch::ContinueDawg(int code, int unichar_id, float cert,
   if (prev != nullptr) {
     score += prev->score;
   }
-  if (dawg_heap->size() >= kBeamWidths[0] &&
+  if (dawg_heap->size() >= BeamWidth(0) &&
       score <= dawg_heap->PeekTop().data().score &&
-      nodawg_heap->size() >= kBeamWidths[0] &&
+      nodawg_heap->size() >= BeamWidth(0) &&
       score <= nodawg_heap->PeekTop().data().score) {
     return;
   }
@@ -1095,7 +1101,7 @@ void RecodeBeamSearch::ContinueDawg(int code, int unichar_id, float cert,
       // space to the top choice beam.
       PushInitialDawgIfBetter(code, unichar_id, uni_prev->permuter, false,
                               false, cert, cont, prev, step);
-      PushHeapIfBetter(kBeamWidths[0], code, unichar_id, uni_prev->permuter,
+      PushHeapIfBetter(BeamWidth(0), code, unichar_id, uni_prev->permuter,
                        false, false, false, false, cert, prev, nullptr,
                        nodawg_heap);
     }
@@ -1125,7 +1131,7 @@ void RecodeBeamSearch::ContinueDawg(int code, int unichar_id, float cert,
   auto permuter = static_cast<PermuterType>(dict_->def_letter_is_okay(
       &dawg_args, dict_->getUnicharset(), unichar_id, false));
   if (permuter != NO_PERM) {
-    PushHeapIfBetter(kBeamWidths[0], code, unichar_id, permuter, false,
+    PushHeapIfBetter(BeamWidth(0), code, unichar_id, permuter, false,
                      word_start, dawg_args.valid_end, false, cert, prev,
                      dawg_args.updated_dawgs, dawg_heap);
     if (dawg_args.valid_end && !space_delimited_) {
@@ -1134,7 +1140,7 @@ void RecodeBeamSearch::ContinueDawg(int code, int unichar_id, float cert,
       // since non-dict words can start here too.
       PushInitialDawgIfBetter(code, unichar_id, permuter, word_start, true,
                               cert, cont, prev, step);
-      PushHeapIfBetter(kBeamWidths[0], code, unichar_id, permuter, false,
+      PushHeapIfBetter(BeamWidth(0), code, unichar_id, permuter, false,
                        word_start, true, false, cert, prev, nullptr,
                        nodawg_heap);
     }
@@ -1178,14 +1184,14 @@ void RecodeBeamSearch::PushDupOrNoDawgIfBetter(
   int index = BeamIndex(use_dawgs, cont, length);
   if (use_dawgs) {
     if (cert > worst_dict_cert) {
-      PushHeapIfBetter(kBeamWidths[length], code, unichar_id,
+      PushHeapIfBetter(BeamWidth(length), code, unichar_id,
                        prev ? prev->permuter : NO_PERM, false, false, false,
                        dup, cert, prev, nullptr, &step->beams_[index]);
     }
   } else {
     cert *= dict_ratio;
     if (cert >= kMinCertainty || code == null_char_) {
-      PushHeapIfBetter(kBeamWidths[length], code, unichar_id,
+      PushHeapIfBetter(BeamWidth(length), code, unichar_id,
                        prev ? prev->permuter : TOP_CHOICE_PERM, false, false,
                        false, dup, cert, prev, nullptr, &step->beams_[index]);
     }
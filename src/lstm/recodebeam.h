@@ -29,6 +29,7 @@
 #include "ratngs.h"
 #include "unicharcompress.h"
 
+#include <algorithm>     // for std::max
 #include <unordered_set> // for std::unordered_set
 #include <vector>        // for std::vector
 
@@ -197,6 +198,15 @@ public:
   RecodeBeamSearch(const UnicharCompress &recoder, int null_char, bool simple_text, Dict *dict);
   ~RecodeBeamSearch();
 
+  // Replaces the borrowed dictionary used by the following searches. With
+  // nullptr the search only follows the top choices, which is faster.
+  void SetDict(Dict *dict);
+  // Halves the beam widths of the following searches if narrow is true,
+  // which is faster but may lose the best path on hard lines.
+  void SetNarrowBeam(bool narrow) {
+    narrow_beam_ = narrow;
+  }
+
   // Decodes the set of network outputs, storing the lattice internally.
   // If charset is not null, it enables detailed debugging of the beam search.
   void Decode(const NetworkIO &output, double dict_ratio, double cert_offset,
@@ -406,6 +416,11 @@ private:
 
   static const int kBeamWidths[RecodedCharID::kMaxCodeLen + 1];
 
+  // Returns the beam width at code position length.
+  int BeamWidth(int length) const {
+    return narrow_beam_ ? std::max(1, kBeamWidths[length] / 2) : kBeamWidths[length];
+  }
+
   // The encoder/decoder that we will be using.
   const UnicharCompress &recoder_;
   // The beam for each timestep in the output.
@@ -430,6 +445,8 @@ private:
   // True if the input is simple text, ie adjacent equal chars are not to be
   // eliminated.
   bool is_simple_text_;
+  // True if the beam widths are halved.
+  bool narrow_beam_;
   // The encoded (class label) of the null/reject character.
   int null_char_;
 };
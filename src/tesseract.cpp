@@ -21,15 +21,23 @@
 #  include "config_auto.h"
 #endif
 
+#include <cctype> // for isdigit
 #include <cerrno> // for errno
 #if defined(__USE_GNU)
 #  include <cfenv> // for feenableexcept
 #endif
+#include <algorithm> // for std::max
 #include <climits> // for INT_MIN, INT_MAX
+#include <condition_variable> // for std::condition_variable
 #include <cstdlib> // for std::getenv
+#include <deque>  // for std::deque
 #include <iostream>
 #include <map>    // for std::map
 #include <memory> // std::unique_ptr
+#include <mutex>  // for std::mutex
+#include <string> // for std::string
+#include <thread> // for std::thread
+#include <vector> // for std::vector
 
 #include <tesseract/baseapi.h>
 #include "dict.h"
@@ -206,6 +214,7 @@ static void PrintHelpExtra(const char *program) {
       "  %s --print-parameters [options...] [configfile...]\n"
       "  %s imagename|imagelist|stdin outputbase|stdout [options...] "
       "[configfile...]\n"
+      "  %s --server [--server-workers N] [options...] [configfile...]\n"
       "\n"
       "OCR options:\n"
       "  --tessdata-dir PATH   Specify the location of tessdata path.\n"
@@ -221,9 +230,21 @@ static void PrintHelpExtra(const char *program) {
 #ifndef DISABLED_LEGACY_ENGINE
       "  --oem OEM|NUM         Specify OCR Engine mode.\n"
 #endif
+      "  --jobs N              Recognize the pages of a multi-page image or image\n"
+      "                        list on N engines at once (0 = one per CPU).\n"
       "NOTE: These options must occur before any configfile.\n"
+      "\n"
+      "Server options:\n"
+      "  --server              Read OCR jobs from stdin, one JSON object per line:\n"
+      "                        {\"id\": ID, \"input\": FILE, \"output\": OUTPUTBASE,\n"
+      "                         \"psm\": PSM, \"formats\": [\"txt\", \"hocr\", ...],\n"
+      "                         \"vars\": {\"VAR\": \"VALUE\", ...}}\n"
+      "                        and write one JSON result line per job to stdout.\n"
+      "                        Without formats, a job writes those of the configs.\n"
+      "  --server-workers N    Run N jobs at a time (0 = one per CPU, default 1).\n"
+      "                        With N > 1, vars cannot set global variables.\n"
       "\n",
-      program, program, program, program
+      program, program, program, program, program
 #ifndef DISABLED_LEGACY_ENGINE
       , program
 #endif  // ndef DISABLED_LEGACY_ENGINE
@@ -368,7 +389,7 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
                       bool *list_langs, bool *print_parameters, bool *print_fonts_table,
                       std::vector<std::string> *vars_vec, std::vector<std::string> *vars_values,
                       l_int32 *arg_i, tesseract::PageSegMode *pagesegmode,
-                      tesseract::OcrEngineMode *enginemode) {
+                      tesseract::OcrEngineMode *enginemode, bool *server, int *server_workers) {
   bool noocr = false;
   int i;
   for (i = 1; i < argc && (*outputbase == nullptr || argv[i][0] == '-'); i++) {
@@ -430,6 +451,10 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
       vars_vec->push_back("user_patterns_file");
       vars_values->push_back(argv[i + 1]);
       ++i;
+    } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+      vars_vec->push_back("tessedit_parallel_pages");
+      vars_values->push_back(argv[i + 1]);
+      ++i;
     } else if (strcmp(argv[i], "--list-langs") == 0) {
       noocr = true;
       *list_langs = true;
@@ -449,6 +474,11 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
       *enginemode = static_cast<tesseract::OcrEngineMode>(oem);
 #endif
       ++i;
+    } else if (strcmp(argv[i], "--server") == 0) {
+      *server = true;
+    } else if (strcmp(argv[i], "--server-workers") == 0 && i + 1 < argc) {
+      *server_workers = atoi(argv[i + 1]);
+      ++i;
     } else if (strcmp(argv[i], "--print-parameters") == 0) {
       noocr = true;
       *print_parameters = true;
@@ -469,6 +499,10 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
       vars_vec->push_back(key);
       vars_values->push_back(value);
       ++i;
+    } else if (*server) {
+      // The server reads its input files from the jobs on stdin, so the
+      // remaining arguments are configs.
+      break;
     } else if (*image == nullptr) {
       *image = argv[i];
     } else {
@@ -492,6 +526,10 @@ static bool ParseArgs(int argc, char **argv, const char **lang, const char **ima
     }
   }
 
+  if (*server) {
+    return true;
+  }
+
   if (*outputbase == nullptr && noocr == false) {
     PrintHelpMessage(argv[0]);
     return false;
@@ -642,6 +680,518 @@ static void PreloadRenderers(tesseract::TessBaseAPI &api,
   }
 }
 
+/**********************************************************************
+ *  Server mode
+ *
+ **********************************************************************/
+
+// A parsed JSON value. Only what the job lines of the server mode need.
+struct JsonValue {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+  Type type = kNull;
+  // The text of strings and numbers, "true" or "false" for booleans.
+  std::string text;
+  std::vector<JsonValue> items;
+  std::vector<std::pair<std::string, JsonValue>> members;
+
+  const JsonValue *Find(const char *name) const {
+    for (const auto &member : members) {
+      if (member.first == name) {
+        return &member.second;
+      }
+    }
+    return nullptr;
+  }
+};
+
+// Recursive descent parser for one line of JSON.
+class JsonParser {
+public:
+  explicit JsonParser(const std::string &input) : input_(input), pos_(0) {}
+
+  // Parses the whole input as one value. Returns false on a syntax error.
+  bool Parse(JsonValue *value) {
+    if (!ParseValue(value, 0)) {
+      return false;
+    }
+    SkipSpace();
+    return pos_ == input_.size();
+  }
+
+private:
+  static const int kMaxDepth = 32;
+
+  void SkipSpace() {
+    while (pos_ < input_.size() && strchr(" \t\r\n", input_[pos_]) != nullptr) {
+      ++pos_;
+    }
+  }
+
+  bool Match(const char *literal) {
+    size_t length = strlen(literal);
+    if (input_.compare(pos_, length, literal) != 0) {
+      return false;
+    }
+    pos_ += length;
+    return true;
+  }
+
+  bool ParseValue(JsonValue *value, int depth) {
+    SkipSpace();
+    if (pos_ >= input_.size() || depth > kMaxDepth) {
+      return false;
+    }
+    char c = input_[pos_];
+    if (c == '{') {
+      value->type = JsonValue::kObject;
+      ++pos_;
+      SkipSpace();
+      if (pos_ < input_.size() && input_[pos_] == '}') {
+        ++pos_;
+        return true;
+      }
+      for (;;) {
+        std::pair<std::string, JsonValue> member;
+        SkipSpace();
+        if (!ParseString(&member.first)) {
+          return false;
+        }
+        SkipSpace();
+        if (!Match(":") || !ParseValue(&member.second, depth + 1)) {
+          return false;
+        }
+        value->members.push_back(std::move(member));
+        SkipSpace();
+        if (Match("}")) {
+          return true;
+        }
+        if (!Match(",")) {
+          return false;
+        }
+      }
+    }
+    if (c == '[') {
+      value->type = JsonValue::kArray;
+      ++pos_;
+      SkipSpace();
+      if (pos_ < input_.size() && input_[pos_] == ']') {
+        ++pos_;
+        return true;
+      }
+      for (;;) {
+        JsonValue item;
+        if (!ParseValue(&item, depth + 1)) {
+          return false;
+        }
+        value->items.push_back(std::move(item));
+        SkipSpace();
+        if (Match("]")) {
+          return true;
+        }
+        if (!Match(",")) {
+          return false;
+        }
+      }
+    }
+    if (c == '"') {
+      value->type = JsonValue::kString;
+      return ParseString(&value->text);
+    }
+    if (Match("true") || Match("false")) {
+      value->type = JsonValue::kBool;
+      value->text = c == 't' ? "true" : "false";
+      return true;
+    }
+    if (Match("null")) {
+      value->type = JsonValue::kNull;
+      return true;
+    }
+    size_t start = pos_;
+    if (!ParseNumber()) {
+      return false;
+    }
+    value->type = JsonValue::kNumber;
+    value->text = input_.substr(start, pos_ - start);
+    return true;
+  }
+
+  // Skips a run of digits. Returns false if there is none.
+  bool SkipDigits() {
+    size_t start = pos_;
+    while (pos_ < input_.size() && isdigit(static_cast<unsigned char>(input_[pos_]))) {
+      ++pos_;
+    }
+    return pos_ > start;
+  }
+
+  // Skips a number as the JSON grammar defines it:
+  // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+  // Returns false on a syntax error, so the text of a number is valid JSON
+  // when it is written back.
+  bool ParseNumber() {
+    Match("-");
+    if (!Match("0") && !SkipDigits()) {
+      return false;
+    }
+    if (Match(".") && !SkipDigits()) {
+      return false;
+    }
+    if (Match("e") || Match("E")) {
+      if (!Match("+")) {
+        Match("-");
+      }
+      if (!SkipDigits()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Appends the code point as UTF-8.
+  static void AppendUTF8(unsigned code, std::string *text) {
+    if (code < 0x80) {
+      *text += static_cast<char>(code);
+    } else if (code < 0x800) {
+      *text += static_cast<char>(0xc0 | (code >> 6));
+      *text += static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+      *text += static_cast<char>(0xe0 | (code >> 12));
+      *text += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      *text += static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+      *text += static_cast<char>(0xf0 | (code >> 18));
+      *text += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+      *text += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+      *text += static_cast<char>(0x80 | (code & 0x3f));
+    }
+  }
+
+  bool ParseHex4(unsigned *code) {
+    if (pos_ + 4 > input_.size()) {
+      return false;
+    }
+    *code = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = input_[pos_++];
+      *code <<= 4;
+      if (c >= '0' && c <= '9') {
+        *code |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        *code |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        *code |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool ParseString(std::string *text) {
+    if (!Match("\"")) {
+      return false;
+    }
+    while (pos_ < input_.size()) {
+      char c = input_[pos_++];
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        *text += c;
+        continue;
+      }
+      if (pos_ >= input_.size()) {
+        return false;
+      }
+      c = input_[pos_++];
+      switch (c) {
+        case 'b':
+          *text += '\b';
+          break;
+        case 'f':
+          *text += '\f';
+          break;
+        case 'n':
+          *text += '\n';
+          break;
+        case 'r':
+          *text += '\r';
+          break;
+        case 't':
+          *text += '\t';
+          break;
+        case 'u': {
+          unsigned code;
+          if (!ParseHex4(&code)) {
+            return false;
+          }
+          if (code >= 0xd800 && code < 0xdc00) {
+            // High surrogate, must be followed by a low one.
+            unsigned low;
+            if (!Match("\\u") || !ParseHex4(&low) || low < 0xdc00 || low >= 0xe000) {
+              return false;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          }
+          AppendUTF8(code, text);
+        } break;
+        default:
+          *text += c;
+          break;
+      }
+    }
+    return false;
+  }
+
+  const std::string &input_;
+  size_t pos_;
+};
+
+// Returns text quoted and escaped as a JSON string.
+static std::string JsonQuote(const std::string &text) {
+  std::string quoted = "\"";
+  for (unsigned char c : text) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+      quoted += c;
+    } else if (c < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", c);
+      quoted += escape;
+    } else {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+// The config variables that select the output formats, by format name.
+static const std::map<std::string, const char *> kServerFormats = {
+    {"alto", "tessedit_create_alto"},         {"box", "tessedit_create_boxfile"},
+    {"hocr", "tessedit_create_hocr"},         {"lstmbox", "tessedit_create_lstmbox"},
+    {"page", "tessedit_create_page_xml"},     {"pdf", "tessedit_create_pdf"},
+    {"tsv", "tessedit_create_tsv"},           {"txt", "tessedit_create_txt"},
+    {"unlv", "tessedit_write_unlv"},          {"wordstrbox", "tessedit_create_wordstrbox"},
+};
+
+// Sets a config variable for the duration of one job and remembers its old
+// value, so that the engine can be reset for the next job.
+class ServerJobVariables {
+public:
+  explicit ServerJobVariables(tesseract::TessBaseAPI &api) : api_(api) {}
+  ~ServerJobVariables() {
+    // Restore in reverse order, so a variable set twice gets its first value.
+    for (auto it = saved_.rbegin(); it != saved_.rend(); ++it) {
+      api_.SetVariable(it->first.c_str(), it->second.c_str());
+    }
+  }
+
+  // Remembers the value of the variable without changing it.
+  bool Save(const std::string &name) {
+    std::string old_value;
+    if (!api_.GetVariableAsString(name.c_str(), &old_value)) {
+      return false;
+    }
+    saved_.emplace_back(name, old_value);
+    return true;
+  }
+
+  bool Set(const std::string &name, const std::string &value) {
+    return Save(name) && api_.SetVariable(name.c_str(), value.c_str());
+  }
+
+private:
+  tesseract::TessBaseAPI &api_;
+  std::vector<std::pair<std::string, std::string>> saved_;
+};
+
+// Returns true if name is a global config variable, which all engines share.
+static bool IsGlobalVariable(const std::string &name) {
+  const ParamsVectors *globals = GlobalParams();
+  const char *c_name = name.c_str();
+  return ParamUtils::FindParam<IntParam>(c_name, globals->int_params, {}) != nullptr ||
+         ParamUtils::FindParam<BoolParam>(c_name, globals->bool_params, {}) != nullptr ||
+         ParamUtils::FindParam<StringParam>(c_name, globals->string_params, {}) != nullptr ||
+         ParamUtils::FindParam<DoubleParam>(c_name, globals->double_params, {}) != nullptr;
+}
+
+// Runs one job line on api. Returns an empty string on success, else the
+// error message. With shared_globals, other jobs run at the same time, so
+// the job may not set global variables, which would leak into them.
+static std::string RunServerJob(tesseract::TessBaseAPI &api, const JsonValue &job,
+                                tesseract::PageSegMode default_psm, bool shared_globals) {
+  const JsonValue *input = job.Find("input");
+  const JsonValue *output = job.Find("output");
+  if (input == nullptr || input->type != JsonValue::kString || input->text.empty()) {
+    return "missing input";
+  }
+  if (output == nullptr || output->type != JsonValue::kString || output->text.empty()) {
+    return "missing output";
+  }
+  if (input->text == "-" || input->text == "stdin") {
+    return "input from stdin is not allowed in server mode";
+  }
+  if (output->text == "-" || output->text == "stdout") {
+    return "output to stdout is not allowed in server mode";
+  }
+
+  ServerJobVariables variables(api);
+  // PreloadRenderers changes it for UNLV output.
+  variables.Save("unlv_tilde_crunching");
+  const JsonValue *formats = job.Find("formats");
+  if (formats != nullptr) {
+    if (formats->type != JsonValue::kArray) {
+      return "formats must be an array";
+    }
+    std::map<std::string, bool> selected;
+    for (const auto &format : kServerFormats) {
+      selected[format.first] = false;
+    }
+    for (const auto &format : formats->items) {
+      if (format.type != JsonValue::kString || selected.count(format.text) == 0) {
+        return "unknown format " + format.text;
+      }
+      selected[format.text] = true;
+    }
+    for (const auto &format : kServerFormats) {
+      variables.Set(format.second, selected[format.first] ? "1" : "0");
+    }
+  }
+  const JsonValue *vars = job.Find("vars");
+  if (vars != nullptr) {
+    if (vars->type != JsonValue::kObject) {
+      return "vars must be an object";
+    }
+    for (const auto &var : vars->members) {
+      if (shared_globals && IsGlobalVariable(var.first)) {
+        return "cannot set global variable " + var.first + " with more than one worker";
+      }
+      if (var.second.type == JsonValue::kArray || var.second.type == JsonValue::kObject ||
+          !variables.Set(var.first, var.second.text)) {
+        return "cannot set variable " + var.first;
+      }
+    }
+  }
+
+  tesseract::PageSegMode pagesegmode = default_psm;
+  const JsonValue *psm = job.Find("psm");
+  if (psm != nullptr) {
+    int value = stringToPSM(psm->text);
+    if (value < 0 || value >= tesseract::PSM_COUNT) {
+      return "invalid psm " + psm->text;
+    }
+    pagesegmode = static_cast<tesseract::PageSegMode>(value);
+  }
+  const tesseract::PageSegMode old_psm = api.GetPageSegMode();
+  api.SetPageSegMode(pagesegmode);
+
+  std::string error;
+  std::vector<std::unique_ptr<TessResultRenderer>> renderers;
+  PreloadRenderers(api, renderers, pagesegmode, output->text.c_str());
+  if (renderers.empty()) {
+    error = "cannot create output files";
+  } else if (!api.ProcessPages(input->text.c_str(), nullptr, 0, renderers[0].get())) {
+    error = "error during processing";
+  }
+  renderers.clear();
+  api.Clear();
+  api.SetPageSegMode(old_psm);
+  return error;
+}
+
+// Reads jobs from stdin, one JSON object per line, and runs them on
+// num_workers engines: api and num_workers - 1 engines initialized from it.
+// Writes one JSON line with the id of the job and its result to stdout for
+// each job, in the order the jobs complete.
+static int RunServer(tesseract::TessBaseAPI &api, tesseract::PageSegMode pagesegmode,
+                     int num_workers) {
+  if (num_workers <= 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::vector<std::unique_ptr<tesseract::TessBaseAPI>> clones;
+  for (int i = 1; i < num_workers; ++i) {
+    auto engine = std::make_unique<tesseract::TessBaseAPI>();
+    if (engine->InitFrom(api) != 0) {
+      fprintf(stderr, "Could not initialize server worker %d.\n", i);
+      return EXIT_FAILURE;
+    }
+    clones.push_back(std::move(engine));
+  }
+
+  std::mutex mutex;
+  std::condition_variable queue_changed;
+  std::deque<std::string> queue;
+  bool done = false;
+  std::mutex output_mutex;
+
+  auto respond = [&output_mutex](const std::string &id, const std::string &error) {
+    std::string response = "{\"id\":" + id + ",\"ok\":" + (error.empty() ? "true" : "false");
+    if (!error.empty()) {
+      response += ",\"error\":" + JsonQuote(error);
+    }
+    response += "}\n";
+    std::lock_guard<std::mutex> lock(output_mutex);
+    fputs(response.c_str(), stdout);
+    fflush(stdout);
+  };
+
+  auto worker = [&](tesseract::TessBaseAPI *engine) {
+    for (;;) {
+      std::string line;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        queue_changed.wait(lock, [&] { return !queue.empty() || done; });
+        if (queue.empty()) {
+          return;
+        }
+        line = std::move(queue.front());
+        queue.pop_front();
+      }
+      queue_changed.notify_all();
+      JsonValue job;
+      if (!JsonParser(line).Parse(&job) || job.type != JsonValue::kObject) {
+        respond("null", "invalid JSON");
+        continue;
+      }
+      const JsonValue *id = job.Find("id");
+      std::string id_text = "null";
+      if (id != nullptr && id->type == JsonValue::kString) {
+        id_text = JsonQuote(id->text);
+      } else if (id != nullptr && id->type == JsonValue::kNumber) {
+        id_text = id->text;
+      }
+      respond(id_text, RunServerJob(*engine, job, pagesegmode, num_workers > 1));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(worker, &api);
+  for (auto &clone : clones) {
+    threads.emplace_back(worker, clone.get());
+  }
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    // Read ahead at most one job per worker.
+    queue_changed.wait(lock, [&] { return queue.size() < threads.size(); });
+    queue.push_back(std::move(line));
+    lock.unlock();
+    queue_changed.notify_all();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  queue_changed.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  return EXIT_SUCCESS;
+}
+
 /**********************************************************************
  *  main()
  *
@@ -674,6 +1224,8 @@ static int main1(int argc, char **argv) {
 #endif
   std::vector<std::string> vars_vec;
   std::vector<std::string> vars_values;
+  bool server = false;
+  int server_workers = 1;
 
   if (std::getenv("LEPT_MSG_SEVERITY")) {
     // Get Leptonica message level from environment variable.
@@ -691,7 +1243,7 @@ static int main1(int argc, char **argv) {
 
   if (!ParseArgs(argc, argv, &lang, &image, &outputbase, &datapath, &dpi, &list_langs,
                  &print_parameters, &print_fonts_table, &vars_vec, &vars_values, &arg_i,
-                 &pagesegmode, &enginemode)) {
+                 &pagesegmode, &enginemode, &server, &server_workers)) {
     return EXIT_FAILURE;
   }
 
@@ -702,7 +1254,7 @@ static int main1(int argc, char **argv) {
     lang = "eng";
   }
 
-  if (image == nullptr && in_recognition_mode) {
+  if (image == nullptr && in_recognition_mode && !server) {
     return EXIT_SUCCESS;
   }
 
@@ -710,6 +1262,9 @@ static int main1(int argc, char **argv) {
   // the TessBaseAPI object. This fixes the order of destructor calls:
   // first TessBaseAPI must be destructed, DawgCache must be the last object.
   tesseract::Dict::GlobalDawgCache();
+#ifndef DISABLED_LEGACY_ENGINE
+  tesseract::Classify::GlobalTemplateCache();
+#endif
 
   TessBaseAPI api;
 
@@ -756,6 +1311,10 @@ static int main1(int argc, char **argv) {
     api.SetVariable("user_defined_dpi", dpi_string.c_str());
   }
 
+  if (server) {
+    return RunServer(api, pagesegmode, server_workers);
+  }
+
   int ret_val = EXIT_SUCCESS;
 
   if (pagesegmode == tesseract::PSM_AUTO_ONLY) {
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////
+// File:        skewfind.cpp
+// Description: Quick estimate of the skew of the text lines of a page.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#  include "config_auto.h"
+#endif
+
+#include "skewfind.h"
+
+#include "detlinefit.h" // for DetLineFit
+#include "rect.h"       // for TBOX
+
+#include <allheaders.h>
+
+#include <algorithm> // for std::sort, std::nth_element
+#include <cmath>     // for std::fabs
+#include <cstdint>   // for int64_t
+#include <cstdlib>   // for std::abs
+#include <utility>   // for std::pair
+#include <vector>    // for std::vector
+
+namespace tesseract {
+
+// Max resolution at which the connected components are found. Text lines
+// are still well apart at this resolution, and the rank 1 reduction merges
+// the characters of words, which only makes the chains longer.
+const int kSkewFindResolution = 150;
+// Max number of 2x reductions to reach kSkewFindResolution.
+const int kMaxSkewReductions = 4;
+// Min height in pixels of a component to consider.
+const int kMinSkewComponentHeight = 3;
+// Components of more than this many median heights wide are not text.
+const int kMaxComponentWidthInHeights = 30;
+// Max number of components to chain. Larger pages are sampled in bands.
+const int kMaxSkewComponents = 3000;
+// Height of the sampling bands in median component heights.
+const int kSkewBandHeightInHeights = 4;
+// Max gap between neighbours in a chain, in median component heights.
+const double kMaxChainGap = 2.0;
+// Max horizontal overlap of neighbours in a chain, in median heights.
+const double kMaxChainOverlap = 0.5;
+// Max vertical offset of the centres of neighbours, in median heights,
+// plus kMaxChainSlope times their horizontal distance.
+const double kMaxChainRise = 0.5;
+const double kMaxChainSlope = 0.1;
+// Min number of components in a chain to fit a line to it.
+const int kMinChainLength = 3;
+// Min number of fitted chains to make an estimate.
+const int kMinSkewChains = 3;
+// Chains agree with the estimate if their gradients are this close to it.
+const double kSkewAgreement = 0.01;
+
+// Returns the text sized components of boxa, the components of the reduced
+// page of the given height, y up, sampled in horizontal bands if there are
+// too many, and sets *median_height. If vertical, the page is first turned
+// 90 degrees anticlockwise, so that text lines running down the page run
+// to the right.
+static std::vector<TBOX> TextComponents(Boxa *boxa, int height, bool vertical,
+                                        int *median_height) {
+  std::vector<TBOX> boxes;
+  std::vector<int> heights;
+  int num_boxes = boxaGetCount(boxa);
+  for (int b = 0; b < num_boxes; ++b) {
+    int x, y, w, h;
+    boxaGetBoxGeometry(boxa, b, &x, &y, &w, &h);
+    TBOX box = vertical ? TBOX(y, x, y + h, x + w) : TBOX(x, height - y - h, x + w, height - y);
+    if (box.height() >= kMinSkewComponentHeight) {
+      boxes.push_back(box);
+      heights.push_back(box.height());
+    }
+  }
+  if (heights.empty()) {
+    *median_height = 0;
+    return boxes;
+  }
+  auto mid = heights.begin() + heights.size() / 2;
+  std::nth_element(heights.begin(), mid, heights.end());
+  int median = *mid;
+  *median_height = median;
+  // Keep characters and words, not noise, rules and pictures.
+  auto is_not_text = [median](const TBOX &box) {
+    return 2 * box.height() < median || box.height() > 2 * median ||
+           box.width() > kMaxComponentWidthInHeights * median;
+  };
+  boxes.erase(std::remove_if(boxes.begin(), boxes.end(), is_not_text), boxes.end());
+  if (boxes.size() > static_cast<size_t>(kMaxSkewComponents)) {
+    // Keep whole bands of the page, so that the chains stay intact.
+    int every = (boxes.size() + kMaxSkewComponents - 1) / kMaxSkewComponents;
+    int band_height = kSkewBandHeightInHeights * median;
+    auto outside_band = [every, band_height](const TBOX &box) {
+      return (box.bottom() + box.top()) / 2 / band_height % every != 0;
+    };
+    boxes.erase(std::remove_if(boxes.begin(), boxes.end(), outside_band), boxes.end());
+  }
+  return boxes;
+}
+
+// Skew of the text lines in one orientation of the page.
+struct SkewEstimate {
+  double gradient = 0.0;
+  // Total width of the chains that agree with gradient, and of all chains.
+  int64_t agreeing_width = 0;
+  int64_t total_width = 0;
+};
+
+// Chains the components left to right into pieces of text line and fits a
+// line to the bottoms of each chain. Returns false if there are too few
+// chains to tell.
+static bool ChainSkew(std::vector<TBOX> boxes, int median, SkewEstimate *estimate) {
+  if (boxes.size() < static_cast<size_t>(kMinChainLength * kMinSkewChains)) {
+    return false;
+  }
+  std::sort(boxes.begin(), boxes.end(),
+            [](const TBOX &a, const TBOX &b) { return a.left() < b.left(); });
+  // Link each component to its nearest unclaimed neighbour to the right
+  // that is on the same text line.
+  int max_gap = static_cast<int>(kMaxChainGap * median);
+  int max_overlap = static_cast<int>(kMaxChainOverlap * median);
+  double max_rise = kMaxChainRise * median;
+  int num_boxes = boxes.size();
+  std::vector<int> next(num_boxes, -1);
+  std::vector<bool> has_prev(num_boxes, false);
+  for (int i = 0; i < num_boxes; ++i) {
+    const TBOX &box = boxes[i];
+    // Twice the centre, to stay in integers.
+    int centre_x = box.left() + box.right();
+    int centre_y = box.bottom() + box.top();
+    int best = -1;
+    int best_gap = max_gap + 1;
+    for (int j = i + 1; j < num_boxes && boxes[j].left() <= box.right() + max_gap; ++j) {
+      const TBOX &other = boxes[j];
+      int gap = other.left() - box.right();
+      int rise = std::abs(other.bottom() + other.top() - centre_y);
+      int distance = other.left() + other.right() - centre_x;
+      if (has_prev[j] || gap < -max_overlap || gap >= best_gap ||
+          rise > 2 * max_rise + kMaxChainSlope * distance) {
+        continue;
+      }
+      best = j;
+      best_gap = gap;
+    }
+    if (best >= 0) {
+      next[i] = best;
+      has_prev[best] = true;
+    }
+  }
+  // Fit a line to the bottoms of each chain, weighted by its length.
+  std::vector<std::pair<double, int>> chains;
+  for (int i = 0; i < num_boxes; ++i) {
+    if (has_prev[i] || next[i] < 0) {
+      continue;
+    }
+    DetLineFit fit;
+    int length = 0;
+    int last = i;
+    for (int b = i; b >= 0; b = next[b]) {
+      fit.Add(ICOORD((boxes[b].left() + boxes[b].right()) / 2, boxes[b].bottom()));
+      ++length;
+      last = b;
+    }
+    if (length < kMinChainLength) {
+      continue;
+    }
+    ICOORD pt1, pt2;
+    fit.Fit(&pt1, &pt2);
+    if (pt1.x() == pt2.x()) {
+      continue;
+    }
+    double chain_gradient = static_cast<double>(pt2.y() - pt1.y()) / (pt2.x() - pt1.x());
+    chains.emplace_back(chain_gradient, boxes[last].right() - boxes[i].left());
+  }
+  if (chains.size() < static_cast<size_t>(kMinSkewChains)) {
+    return false;
+  }
+  // The weighted median is robust to the chains that cross lines, and the
+  // mean of the chains that agree with it refines it.
+  std::sort(chains.begin(), chains.end());
+  int64_t total_weight = 0;
+  for (auto &chain : chains) {
+    total_weight += chain.second;
+  }
+  double median_gradient = chains.back().first;
+  int64_t weight = 0;
+  for (auto &chain : chains) {
+    weight += chain.second;
+    if (2 * weight >= total_weight) {
+      median_gradient = chain.first;
+      break;
+    }
+  }
+  double sum = 0.0;
+  int64_t agreeing_weight = 0;
+  for (auto &chain : chains) {
+    if (std::fabs(chain.first - median_gradient) <= kSkewAgreement) {
+      sum += chain.first * chain.second;
+      agreeing_weight += chain.second;
+    }
+  }
+  estimate->gradient = sum / agreeing_weight;
+  estimate->agreeing_width = agreeing_weight;
+  estimate->total_width = total_weight;
+  return true;
+}
+
+bool FindTextSkew(Image pix, int resolution, float *gradient, float *confidence,
+                  bool *vertical) {
+  if (pix == nullptr || pixGetDepth(pix) != 1) {
+    return false;
+  }
+  int levels = 0;
+  while (levels < kMaxSkewReductions && resolution > kSkewFindResolution << levels) {
+    ++levels;
+  }
+  Image reduced = levels == 0 ? pix.clone()
+                              : Image(pixReduceRankBinaryCascade(pix, 1, levels > 1 ? 1 : 0,
+                                                                 levels > 2 ? 1 : 0,
+                                                                 levels > 3 ? 1 : 0));
+  if (reduced == nullptr) {
+    return false;
+  }
+  int height = pixGetHeight(reduced);
+  Boxa *boxa = pixConnCompBB(reduced, 8);
+  reduced.destroy();
+  if (boxa == nullptr) {
+    return false;
+  }
+  // Chain the components both ways. Across the real text lines the chains
+  // link neighbouring lines at random and rarely agree with each other, so
+  // the text lines run the way with the most agreeing chained text.
+  SkewEstimate estimates[2];
+  bool found[2];
+  for (int v = 0; v < 2; ++v) {
+    int median = 0;
+    std::vector<TBOX> boxes = TextComponents(boxa, height, v != 0, &median);
+    found[v] = ChainSkew(std::move(boxes), median, &estimates[v]);
+  }
+  boxaDestroy(&boxa);
+  if (!found[0] && !found[1]) {
+    return false;
+  }
+  bool is_vertical =
+      !found[0] || (found[1] && estimates[1].agreeing_width > estimates[0].agreeing_width);
+  const SkewEstimate &best = estimates[is_vertical ? 1 : 0];
+  *gradient = best.gradient;
+  *confidence = static_cast<float>(best.agreeing_width) / best.total_width;
+  *vertical = is_vertical;
+  return true;
+}
+
+} // namespace tesseract
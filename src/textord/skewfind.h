@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////
+// File:        skewfind.h
+// Description: Quick estimate of the skew of the text lines of a page.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_TEXTORD_SKEWFIND_H_
+#define TESSERACT_TEXTORD_SKEWFIND_H_
+
+#include "image.h" // for Image
+
+namespace tesseract {
+
+// Estimates the skew of the text lines of the binary image pix, of the given
+// resolution, without any layout analysis. The connected components of a
+// reduced copy of the page are chained left to right into pieces of text
+// line, and a line is fitted to the bottoms of each chain with DetLineFit.
+// The components are chained both across and down the page, and the text
+// lines are taken to run the way in which most of the chained text agrees.
+// On success, returns true with *vertical true if the text lines run down
+// the page, *gradient the slope of the text lines as dy/dx with y up, as
+// given by TessBaseAPI::GetGradient after layout analysis, measured after
+// turning the page 90 degrees anticlockwise if *vertical, and *confidence in
+// [0, 1] the fraction of the chained text that agrees with it.
+// Returns false if there is too little text to tell.
+bool FindTextSkew(Image pix, int resolution, float *gradient, float *confidence,
+                  bool *vertical);
+
+} // namespace tesseract
+
+#endif // TESSERACT_TEXTORD_SKEWFIND_H_
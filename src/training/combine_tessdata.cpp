@@ -18,8 +18,10 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "commontraining.h" // CheckSharedLibraryVersion
+#include "configbundle.h"
 #include "lstmrecognizer.h"
 #include "tessdatamanager.h"
+#include "tesseractclass.h"
 
 #include <cerrno>
 #include <iostream> // std::cout
@@ -36,6 +38,55 @@ static int list_components(TessdataManager &tm, const char *filename) {
   return EXIT_SUCCESS;
 }
 
+// Adds the given text config files to the config bundle of the traineddata
+// file, keeping any configs already in it that are not replaced. Each config
+// is named by the file name of its path, eg configs/hocr becomes hocr.
+static int bundle_configs(TessdataManager &tm, const char *filename,
+                          char **config_files, int num_config_files) {
+  if (!tm.Init(filename)) {
+    tprintf("Failed to read %s\n", filename);
+    return EXIT_FAILURE;
+  }
+  tesseract::ConfigBundle bundle;
+  tesseract::TFile fp;
+  if (tm.GetComponent(tesseract::TESSDATA_CONFIG_BUNDLE, &fp) && !bundle.DeSerialize(&fp)) {
+    tprintf("Failed to read the config bundle in %s!\n", filename);
+    return EXIT_FAILURE;
+  }
+  // Parameter names are checked against those of a Tesseract instance, so
+  // that unknown names are reported now rather than at every Init.
+  tesseract::Tesseract tess;
+  bool anyerr = false;
+  for (int i = 0; i < num_config_files; ++i) {
+    std::string name = config_files[i];
+    auto separator = name.find_last_of("/\\");
+    if (separator != std::string::npos) {
+      name.erase(0, separator + 1);
+    }
+    tesseract::TFile config_fp;
+    if (name.empty() || !config_fp.Open(config_files[i], nullptr)) {
+      tprintf("Failed to read config file %s\n", config_files[i]);
+      anyerr = true;
+    } else if (bundle.AddConfig(name, &config_fp, tess.params())) {
+      printf("Bundled %s as %s\n", config_files[i], name.c_str());
+    } else {
+      anyerr = true;
+    }
+  }
+  if (anyerr) {
+    return EXIT_FAILURE;
+  }
+  std::vector<char> bundle_data;
+  fp.OpenWrite(&bundle_data);
+  ASSERT_HOST(bundle.Serialize(&fp));
+  tm.OverwriteEntry(tesseract::TESSDATA_CONFIG_BUNDLE, &bundle_data[0], bundle_data.size());
+  if (!tm.SaveFile(filename, nullptr)) {
+    tprintf("Failed to write modified traineddata:%s!\n", filename);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
 static int list_network(TessdataManager &tm, const char *filename) {
   if (filename != nullptr && !tm.Init(filename)) {
     tprintf("Failed to read %s\n", filename);
@@ -114,6 +165,16 @@ static int list_network(TessdataManager &tm, const char *filename) {
 // This will create  /home/$USER/temp/eng.* files with individual tessdata
 // components from tessdata/eng.traineddata.
 //
+// Specify option -b to precompile named config files into the config bundle
+// of the given [lang].traineddata file:
+//
+// combine_tessdata -b tessdata/eng.traineddata tessdata/configs/hocr
+//   tessdata/configs/pdf tessdata/configs/txt
+//
+// Unknown parameter names and bad values are reported and nothing is
+// written. Afterwards "tesseract ... hocr" applies the bundled hocr config
+// instead of reading tessdata/configs/hocr.
+//
 int main(int argc, char **argv) {
   tesseract::CheckSharedLibraryVersion();
 
@@ -219,6 +280,11 @@ int main(int argc, char **argv) {
       tprintf("Failed to write modified traineddata:%s!\n", argv[2]);
       return EXIT_FAILURE;
     }
+  } else if (argc >= 4 && strcmp(argv[1], "-b") == 0) {
+    int result = bundle_configs(tm, argv[2], argv + 3, argc - 3);
+    if (result != EXIT_SUCCESS) {
+      return result;
+    }
   } else if (argc == 3 && strcmp(argv[1], "-d") == 0) {
     return list_components(tm, argv[2]);
   } else if (argc == 3 && strcmp(argv[1], "-l") == 0) {
@@ -270,8 +336,13 @@ int main(int argc, char **argv) {
         );
     printf(
         "Usage for compacting LSTM component to int:\n"
-        "  %s -c traineddata_file\n",
+        "  %s -c traineddata_file\n\n",
         argv[0]);
+    printf(
+        "Usage for precompiling config files into the traineddata:\n"
+        "  %s -b traineddata_file config_file...\n"
+        "  (e.g. %s -b eng.traineddata configs/hocr configs/txt)\n",
+        argv[0], argv[0]);
     return EXIT_FAILURE;
   }
   tm.Directory();
@@ -14,15 +14,25 @@
 #include "cycletimer.h" // for CycleTimer
 #include "image.h"      // for Image
 #include "log.h"        // for LOG
+#include "lstmrecognizer.h" // for PolarityCounts
 #include "ocrblock.h"   // for class BLOCK
 #include "pageres.h"
+#include "tesseractclass.h"
+#include "thresholder.h" // for ThresholdMethod
 
+#include <tesseract/asyncapi.h>
 #include <tesseract/baseapi.h>
+#include <tesseract/renderer.h>
 
 #include "gmock/gmock-matchers.h"
 
+#include <atomic>
+#include <future>
+#include <map>
 #include <memory>
 #include <regex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -136,6 +146,426 @@ TEST_F(TesseractTest, HOCRWorksWithoutSetInputName) {
   src_pix.destroy();
 }
 
+// A borrowed image in a directly usable format is recognized in place and
+// gives the same result as a copied one.
+TEST_F(TesseractTest, SetImageBorrowedTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  Image grey_pix = pixConvertTo8(src_pix, false);
+  api.SetImage(grey_pix);
+  char *copied_text = api.GetUTF8Text();
+  ASSERT_TRUE(copied_text != nullptr);
+  EXPECT_NE(pixGetData(grey_pix), pixGetData(api.GetInputImage()));
+  api.SetImageBorrowed(grey_pix);
+  EXPECT_EQ(pixGetData(grey_pix), pixGetData(api.GetInputImage()));
+  char *borrowed_text = api.GetUTF8Text();
+  ASSERT_TRUE(borrowed_text != nullptr);
+  EXPECT_STREQ(copied_text, borrowed_text);
+  delete[] copied_text;
+  delete[] borrowed_text;
+  api.Clear();
+  grey_pix.destroy();
+  src_pix.destroy();
+}
+
+// The flat result has the same words, boxes and confidences as a walk
+// with a ResultIterator.
+TEST_F(TesseractTest, FlatResultTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  tesseract::TessFlatResult result;
+  EXPECT_TRUE(api.GetFlatResult(&result));
+  EXPECT_THAT(result.text, HasSubstr("This is a lot of 12 point text"));
+  EXPECT_EQ(result.lines.size(), result.baseline_x1.size());
+  const std::unique_ptr<tesseract::ResultIterator> it(api.GetIterator());
+  size_t w = 0;
+  do {
+    if (it->Empty(tesseract::RIL_WORD)) {
+      continue;
+    }
+    ASSERT_LT(w, result.words.size());
+    char *word = it->GetUTF8Text(tesseract::RIL_WORD);
+    EXPECT_EQ(word, result.text.substr(result.words.text_offset[w],
+                                       result.words.text_length[w]));
+    delete[] word;
+    int left, top, right, bottom;
+    it->BoundingBox(tesseract::RIL_WORD, &left, &top, &right, &bottom);
+    EXPECT_EQ(left, result.words.left[w]);
+    EXPECT_EQ(bottom, result.words.bottom[w]);
+    EXPECT_FLOAT_EQ(it->Confidence(tesseract::RIL_WORD), result.words.confidence[w]);
+    ++w;
+  } while (it->Next(tesseract::RIL_WORD));
+  EXPECT_EQ(w, result.words.size());
+  for (size_t s = 0; s < result.symbols.size(); ++s) {
+    int parent = result.symbols.parent[s];
+    ASSERT_LT(parent, static_cast<int>(result.words.size()));
+    EXPECT_GE(result.symbols.text_offset[s], result.words.text_offset[parent]);
+  }
+  // Blocks are separated by an empty line and the lines of a block by a
+  // newline.
+  for (size_t b = 1; b < result.blocks.size(); ++b) {
+    int end = result.blocks.text_offset[b - 1] + result.blocks.text_length[b - 1];
+    EXPECT_EQ("\n\n", result.text.substr(end, result.blocks.text_offset[b] - end));
+  }
+  for (size_t l = 1; l < result.lines.size(); ++l) {
+    if (result.lines.parent[l] == result.lines.parent[l - 1]) {
+      int end = result.lines.text_offset[l - 1] + result.lines.text_length[l - 1];
+      EXPECT_EQ("\n", result.text.substr(end, result.lines.text_offset[l] - end));
+    }
+  }
+  // Reusing the result replaces its contents.
+  std::string text = result.text;
+  EXPECT_TRUE(api.GetFlatResult(&result));
+  EXPECT_EQ(text, result.text);
+  src_pix.destroy();
+}
+
+// Strips that overlap by more than a text line find every word once.
+TEST_F(TesseractTest, RecognizeStripsTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  tesseract::TessFlatResult page;
+  EXPECT_TRUE(api.GetFlatResult(&page));
+  tesseract::TessFlatResult strips;
+  EXPECT_FALSE(api.RecognizeStrips(100, 50, &strips));
+  EXPECT_TRUE(api.RecognizeStrips(200, 80, &strips));
+  EXPECT_THAT(strips.text, HasSubstr("This is a lot of 12 point text"));
+  EXPECT_EQ(page.words.size(), strips.words.size());
+  EXPECT_EQ(strips.lines.size(), strips.baseline_x1.size());
+  for (size_t w = 1; w < strips.words.size(); ++w) {
+    EXPECT_GE(strips.words.top[w], strips.words.top[w - 1] - 80);
+  }
+  // The rectangle is reset to the whole image afterwards.
+  tesseract::TessFlatResult again;
+  EXPECT_TRUE(api.GetFlatResult(&again));
+  EXPECT_EQ(page.text, again.text);
+  src_pix.destroy();
+}
+
+// Frames only recognize the strips that changed, with the same results as
+// recognizing all strips.
+TEST_F(TesseractTest, RecognizeFrameTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  tesseract::TessFlatResult strips;
+  EXPECT_TRUE(api.RecognizeStrips(200, 80, &strips));
+  tesseract::TessFlatResult frame;
+  int recognized = 0;
+  EXPECT_FALSE(api.RecognizeFrame(100, 50, &frame, &recognized));
+  EXPECT_TRUE(api.RecognizeFrame(200, 80, &frame, &recognized));
+  int num_strips = recognized;
+  EXPECT_GT(num_strips, 1);
+  EXPECT_EQ(strips.text, frame.text);
+  EXPECT_EQ(strips.words.size(), frame.words.size());
+  EXPECT_EQ(strips.words.parent, frame.words.parent);
+  // The same frame again reuses every strip.
+  api.SetImage(src_pix);
+  EXPECT_TRUE(api.RecognizeFrame(200, 80, &frame, &recognized));
+  EXPECT_EQ(0, recognized);
+  EXPECT_EQ(strips.text, frame.text);
+  // Clearing the top rows only changes the first strip.
+  Image changed_pix = src_pix.copy();
+  Box *top_rows = boxCreate(0, 0, pixGetWidth(changed_pix), 100);
+  pixClearInRect(changed_pix, top_rows);
+  boxDestroy(&top_rows);
+  api.SetImage(changed_pix);
+  EXPECT_TRUE(api.RecognizeFrame(200, 80, &frame, &recognized));
+  EXPECT_EQ(1, recognized);
+  EXPECT_TRUE(api.RecognizeStrips(200, 80, &strips));
+  EXPECT_EQ(strips.text, frame.text);
+  EXPECT_EQ(strips.lines.parent, frame.lines.parent);
+  // After ClearFrames, every strip is recognized again.
+  api.ClearFrames();
+  EXPECT_TRUE(api.RecognizeFrame(200, 80, &frame, &recognized));
+  EXPECT_EQ(num_strips, recognized);
+  changed_pix.destroy();
+  src_pix.destroy();
+}
+
+// The streaming writers produce the same markup as the string getters.
+TEST_F(TesseractTest, WriteMarkupTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  std::ostringstream hocr, alto, page;
+  EXPECT_TRUE(api.WriteHOCRText(hocr, nullptr, 0));
+  EXPECT_TRUE(api.WriteAltoText(alto, nullptr, 0));
+  EXPECT_TRUE(api.WritePAGEText(page, nullptr, 0));
+  std::unique_ptr<char[]> text(api.GetHOCRText(0));
+  EXPECT_EQ(text.get(), hocr.str());
+  text.reset(api.GetAltoText(0));
+  EXPECT_EQ(text.get(), alto.str());
+  text.reset(api.GetPAGEText(0));
+  EXPECT_EQ(text.get(), page.str());
+  EXPECT_THAT(hocr.str(), HasSubstr("Hello"));
+  // A blank page has no regions, but its markup is still complete.
+  Image blank_pix = pixCreate(200, 100, 1);
+  api.SetImage(blank_pix);
+  std::ostringstream blank_page;
+  EXPECT_TRUE(api.WritePAGEText(blank_page, nullptr, 0));
+  EXPECT_FALSE(blank_page.fail());
+  EXPECT_THAT(blank_page.str(), HasSubstr("</Page>"));
+  text.reset(api.GetPAGEText(0));
+  EXPECT_EQ(text.get(), blank_page.str());
+  blank_pix.destroy();
+  src_pix.destroy();
+}
+
+// TSV and ALTO renderers of one chain share a render model and must write
+// the same markup as the direct API calls.
+TEST_F(TesseractTest, RenderModelTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  api.SetImage(src_pix);
+  const std::string outputbase = file::JoinPath(FLAGS_test_tmpdir, "rendermodel");
+  {
+    tesseract::TessTsvRenderer renderer(outputbase.c_str());
+    renderer.insert(new tesseract::TessAltoRenderer(outputbase.c_str()));
+    EXPECT_TRUE(renderer.BeginDocument("rendermodel"));
+    EXPECT_TRUE(renderer.AddImage(&api));
+    EXPECT_TRUE(renderer.EndDocument());
+  }
+  std::string tsv, alto;
+  CHECK(file::GetContents(outputbase + ".tsv", &tsv, file::Defaults()));
+  CHECK(file::GetContents(outputbase + ".xml", &alto, file::Defaults()));
+  std::unique_ptr<char[]> text(api.GetTSVText(0));
+  EXPECT_THAT(tsv, HasSubstr(text.get()));
+  EXPECT_THAT(text.get(), HasSubstr("Hello"));
+  text.reset(api.GetAltoText(0));
+  EXPECT_THAT(alto, HasSubstr(text.get()));
+  src_pix.destroy();
+}
+
+// All thresholding methods must give a binary image of the page size and
+// recognize the text.
+TEST_F(TesseractTest, ThresholdingMethodsTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  for (int method = 0; method < static_cast<int>(tesseract::ThresholdMethod::Max); ++method) {
+    api.SetVariable("thresholding_method", std::to_string(method).c_str());
+    api.SetImage(src_pix);
+    Image binary = api.GetThresholdedImage();
+    ASSERT_TRUE(binary != nullptr);
+    EXPECT_EQ(pixGetDepth(binary), 1);
+    EXPECT_EQ(pixGetWidth(binary), pixGetWidth(src_pix));
+    EXPECT_EQ(pixGetHeight(binary), pixGetHeight(src_pix));
+    binary.destroy();
+    std::unique_ptr<char[]> text(api.GetUTF8Text());
+    EXPECT_THAT(text.get(), HasSubstr("Hello")) << "thresholding_method " << method;
+  }
+  src_pix.destroy();
+}
+
+// Away from the image borders, where Leptonica mirrors the window and the
+// integral version clips it, IntegralSauvola must binarize like Sauvola.
+TEST_F(TesseractTest, IntegralSauvolaMatchesSauvolaTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  // A grey page with a shaded background and dark blocks of several sizes.
+  const int kWidth = 400;
+  const int kHeight = 300;
+  const int kResolution = 100;
+  Image src_pix = pixCreate(kWidth, kHeight, 8);
+  pixSetResolution(src_pix, kResolution, kResolution);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      int value = 150 + 80 * x / kWidth;
+      if ((x / 7) % 3 == 0 && (y / 11) % 2 == 0) {
+        value = 40 + (x + y) % 20;
+      }
+      pixSetPixel(src_pix, x, y, value);
+    }
+  }
+  // SetImage drops the thresholded image of the previous method.
+  api.SetVariable("thresholding_method",
+                  std::to_string(static_cast<int>(tesseract::ThresholdMethod::Sauvola)).c_str());
+  api.SetImage(src_pix);
+  Image sauvola = api.GetThresholdedImage();
+  api.SetVariable(
+      "thresholding_method",
+      std::to_string(static_cast<int>(tesseract::ThresholdMethod::IntegralSauvola)).c_str());
+  api.SetImage(src_pix);
+  Image integral = api.GetThresholdedImage();
+  ASSERT_TRUE(sauvola != nullptr);
+  ASSERT_TRUE(integral != nullptr);
+  // Leave out the border that the window of either method can reach.
+  double window_size_factor;
+  EXPECT_TRUE(api.GetDoubleVariable("thresholding_window_size", &window_size_factor));
+  int border = static_cast<int>(window_size_factor * kResolution) / 2 + 1;
+  Box *interior = boxCreate(border, border, kWidth - 2 * border, kHeight - 2 * border);
+  Image sauvola_interior = pixClipRectangle(sauvola, interior, nullptr);
+  Image integral_interior = pixClipRectangle(integral, interior, nullptr);
+  boxDestroy(&interior);
+  Image diff = pixXor(nullptr, sauvola_interior, integral_interior);
+  l_int32 num_different;
+  pixCountPixels(diff, &num_different, nullptr);
+  // Only the rounding of the mean and deviation differs.
+  EXPECT_LE(num_different, pixGetWidth(diff) * pixGetHeight(diff) / 1000);
+  l_int32 num_black;
+  pixCountPixels(integral_interior, &num_black, nullptr);
+  EXPECT_GT(num_black, 0);
+  diff.destroy();
+  integral_interior.destroy();
+  sauvola_interior.destroy();
+  integral.destroy();
+  sauvola.destroy();
+  src_pix.destroy();
+}
+
+// The skew estimate must find the rotation of a rotated page without
+// layout analysis.
+TEST_F(TesseractTest, EstimateSkewTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  float angle, confidence;
+  bool vertical = true;
+  api.SetImage(src_pix);
+  EXPECT_TRUE(api.EstimateSkew(&angle, &confidence, &vertical));
+  EXPECT_NEAR(angle, 0.0f, 0.3f);
+  EXPECT_GT(confidence, 0.5f);
+  EXPECT_FALSE(vertical);
+  // pixRotate turns clockwise, so the lines then fall to the right.
+  const float kDegrees = 3.0f;
+  Image rotated_pix = pixRotate(src_pix, kDegrees * M_PI / 180, L_ROTATE_SAMPLING,
+                                L_BRING_IN_WHITE, 0, 0);
+  CHECK(rotated_pix);
+  api.SetImage(rotated_pix);
+  EXPECT_TRUE(api.EstimateSkew(&angle, &confidence));
+  EXPECT_NEAR(angle, -kDegrees, 0.3f);
+  EXPECT_GT(confidence, 0.5f);
+  // Turned a quarter clockwise, the lines run down the page, and turning
+  // them back anticlockwise gives the same skew.
+  Image turned_pix = pixRotateOrth(rotated_pix, 1);
+  CHECK(turned_pix);
+  api.SetImage(turned_pix);
+  EXPECT_TRUE(api.EstimateSkew(&angle, &confidence, &vertical));
+  EXPECT_TRUE(vertical);
+  EXPECT_NEAR(angle, -kDegrees, 0.3f);
+  EXPECT_GT(confidence, 0.5f);
+  turned_pix.destroy();
+  rotated_pix.destroy();
+  src_pix.destroy();
+}
+
+// Finding the blocks of a high resolution page on a reduced image must find
+// the same text.
+TEST_F(TesseractTest, ReducedLayoutTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  Image large_pix = pixScale(src_pix, 2.0f, 2.0f);
+  CHECK(large_pix);
+  for (const char *max_resolution : {"0", "300"}) {
+    api.SetVariable("pageseg_layout_max_resolution", max_resolution);
+    api.SetImage(large_pix);
+    api.SetSourceResolution(600);
+    std::unique_ptr<char[]> text(api.GetUTF8Text());
+    EXPECT_THAT(text.get(), HasSubstr("This is a lot of 12 point text"))
+        << "pageseg_layout_max_resolution " << max_resolution;
+    EXPECT_THAT(text.get(), HasSubstr("The quick brown dog jumped"))
+        << "pageseg_layout_max_resolution " << max_resolution;
+  }
+  large_pix.destroy();
+  src_pix.destroy();
+}
+
+// A rule line found on the reduced image must be removed from the full
+// resolution image too, as it is when the layout is found at full
+// resolution.
+TEST_F(TesseractTest, ReducedLayoutRuleLineTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  Image large_pix = pixScale(src_pix, 2.0f, 2.0f);
+  CHECK(large_pix);
+  ASSERT_EQ(1, pixGetDepth(large_pix));
+  // Add a white margin below the text and rule a line across it.
+  const int kMargin = 100;
+  const int kLineWidth = 6;
+  Image ruled_pix = pixAddBorderGeneral(large_pix, 0, 0, 0, kMargin, 0);
+  CHECK(ruled_pix);
+  int width = pixGetWidth(ruled_pix);
+  int line_y = pixGetHeight(ruled_pix) - kMargin / 2;
+  pixRenderLine(ruled_pix, 20, line_y, width - 20, line_y, kLineWidth, L_SET_PIXELS);
+  Box *line_box = boxCreate(20, line_y - kLineWidth, width - 40, 2 * kLineWidth);
+  l_int32 line_pixels;
+  pixCountPixelsInRect(ruled_pix, line_box, &line_pixels, nullptr);
+  ASSERT_GT(line_pixels, 0);
+  for (const char *max_resolution : {"0", "300"}) {
+    api.SetVariable("pageseg_layout_max_resolution", max_resolution);
+    api.SetImage(ruled_pix);
+    api.SetSourceResolution(600);
+    std::unique_ptr<char[]> text(api.GetUTF8Text());
+    EXPECT_THAT(text.get(), HasSubstr("This is a lot of 12 point text"))
+        << "pageseg_layout_max_resolution " << max_resolution;
+    Image binary = api.GetThresholdedImage();
+    ASSERT_TRUE(binary != nullptr);
+    l_int32 remaining_pixels;
+    pixCountPixelsInRect(binary, line_box, &remaining_pixels, nullptr);
+    EXPECT_LT(remaining_pixels, line_pixels / 20)
+        << "pageseg_layout_max_resolution " << max_resolution;
+    binary.destroy();
+  }
+  boxDestroy(&line_box);
+  ruled_pix.destroy();
+  large_pix.destroy();
+  src_pix.destroy();
+}
+
 // hOCR output should contain baseline info for upright textlines.
 TEST_F(TesseractTest, HOCRContainsBaseline) {
   tesseract::TessBaseAPI api;
@@ -157,6 +587,273 @@ TEST_F(TesseractTest, HOCRContainsBaseline) {
   src_pix.destroy();
 }
 
+// Instances using the same traineddata should share one copy of the static
+// classifier templates, while each keeps its own font tables.
+TEST_F(TesseractTest, SharedStaticTemplatesTest) {
+#ifdef DISABLED_LEGACY_ENGINE
+  // Skip test because there is no static classifier.
+  GTEST_SKIP();
+#else
+  tesseract::TessBaseAPI api1;
+  tesseract::TessBaseAPI api2;
+  if (api1.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1 ||
+      api2.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Tesseract *tess1 = api1.tesseract();
+  Tesseract *tess2 = api2.tesseract();
+  EXPECT_TRUE(tess1->PreTrainedTemplates != nullptr);
+  EXPECT_EQ(tess1->PreTrainedTemplates, tess2->PreTrainedTemplates);
+  EXPECT_EQ(tess1->shape_table(), tess2->shape_table());
+  EXPECT_NE(&tess1->get_fontinfo_table(), &tess2->get_fontinfo_table());
+  EXPECT_EQ(tess1->get_fontinfo_table().size(), tess2->get_fontinfo_table().size());
+  EXPECT_EQ(tess1->get_fontset_table().size(), tess2->get_fontset_table().size());
+
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  std::string text1 = GetCleanedTextResult(&api1, src_pix);
+  EXPECT_EQ(text1, GetCleanedTextResult(&api2, src_pix));
+  // The remaining instance must still work after the other one has ended.
+  api2.End();
+  EXPECT_EQ(text1, GetCleanedTextResult(&api1, src_pix));
+  src_pix.destroy();
+#endif
+}
+
+// Adapted templates saved for a document class can be loaded into another
+// instance, either replacing or merging with what it has learned.
+TEST_F(TesseractTest, AdaptedTemplatesStoreTest) {
+#ifdef DISABLED_LEGACY_ENGINE
+  // Skip test because there is no adaptive classifier.
+  GTEST_SKIP();
+#else
+  tesseract::TessBaseAPI api1;
+  tesseract::TessBaseAPI api2;
+  if (api1.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1 ||
+      api2.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  file::MakeTmpdir();
+  api1.SetVariable("classify_adapted_templates_dir", FLAGS_test_tmpdir);
+  api2.SetVariable("classify_adapted_templates_dir", FLAGS_test_tmpdir);
+
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  std::string text = GetCleanedTextResult(&api1, src_pix);
+  EXPECT_TRUE(api1.SaveAdaptedTemplates("hello_form"));
+
+  EXPECT_FALSE(api2.LoadAdaptedTemplates("no_such_form", false));
+  EXPECT_FALSE(api2.LoadAdaptedTemplates("../hello_form", false));
+  EXPECT_TRUE(api2.LoadAdaptedTemplates("hello_form", false));
+  EXPECT_TRUE(api2.LoadAdaptedTemplates("hello_form", true));
+  EXPECT_EQ(text, GetCleanedTextResult(&api2, src_pix));
+  src_pix.destroy();
+#endif
+}
+
+#ifndef DISABLED_LEGACY_ENGINE
+// Returns the number of protos and permanent configs of each adapted class
+// of api, by class id.
+static std::map<int, std::pair<int, int>> AdaptedClasses(tesseract::TessBaseAPI *api) {
+  std::map<int, std::pair<int, int>> classes;
+  const tesseract::ADAPT_TEMPLATES_STRUCT *templates = api->tesseract()->AdaptedTemplates;
+  for (unsigned id = 0; id < templates->Templates->NumClasses; ++id) {
+    const tesseract::ADAPT_CLASS_STRUCT *adapted_class = templates->Class[id];
+    if (!IsEmptyAdaptedClass(adapted_class)) {
+      classes[id] = {tesseract::ClassForClassId(templates->Templates, id)->NumProtos,
+                     adapted_class->NumPermConfigs};
+    }
+  }
+  return classes;
+}
+#endif
+
+// Merging adapted templates keeps the classes already adapted and adds those
+// that were only adapted in the file, with their protos and configs.
+TEST_F(TesseractTest, AdaptedTemplatesMergeTest) {
+#ifdef DISABLED_LEGACY_ENGINE
+  // Skip test because there is no adaptive classifier.
+  GTEST_SKIP();
+#else
+  tesseract::TessBaseAPI api1;
+  tesseract::TessBaseAPI api2;
+  if (api1.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1 ||
+      api2.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  file::MakeTmpdir();
+  api1.SetVariable("classify_adapted_templates_dir", FLAGS_test_tmpdir);
+  api2.SetVariable("classify_adapted_templates_dir", FLAGS_test_tmpdir);
+
+  // Pages with different characters adapt different classes.
+  Image page_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(page_pix);
+  Image hello_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(hello_pix);
+  GetCleanedTextResult(&api1, page_pix);
+  GetCleanedTextResult(&api2, hello_pix);
+  auto saved = AdaptedClasses(&api1);
+  auto own = AdaptedClasses(&api2);
+  ASSERT_FALSE(saved.empty());
+  ASSERT_FALSE(own.empty());
+  size_t num_saved_only = 0;
+  for (auto &adapted : saved) {
+    num_saved_only += own.count(adapted.first) == 0;
+  }
+  ASSERT_GT(num_saved_only, 0u);
+  EXPECT_TRUE(api1.SaveAdaptedTemplates("photo_form"));
+
+  EXPECT_TRUE(api2.LoadAdaptedTemplates("photo_form", true));
+  auto merged = AdaptedClasses(&api2);
+  EXPECT_EQ(own.size() + num_saved_only, merged.size());
+  EXPECT_EQ(static_cast<int>(merged.size()),
+            api2.tesseract()->AdaptedTemplates->NumNonEmptyClasses);
+  for (auto &adapted : own) {
+    EXPECT_EQ(adapted.second, merged[adapted.first]) << "own class " << adapted.first;
+  }
+  for (auto &adapted : saved) {
+    if (own.count(adapted.first) == 0) {
+      EXPECT_EQ(adapted.second, merged[adapted.first]) << "saved class " << adapted.first;
+    }
+  }
+
+  // Without merge, only the saved classes remain.
+  EXPECT_TRUE(api2.LoadAdaptedTemplates("photo_form", false));
+  EXPECT_EQ(saved, AdaptedClasses(&api2));
+  hello_pix.destroy();
+  page_pix.destroy();
+#endif
+}
+
+// Recognizing the pages of an image list on several engines produces the
+// same output, in the same page order, as recognizing them one at a time.
+TEST_F(TesseractTest, ParallelPagesTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng") == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  api.SetVariable("tessedit_char_blacklist", "xyz");
+  tesseract::TessBaseAPI clone;
+  EXPECT_EQ(0, clone.InitFrom(api));
+  EXPECT_STREQ("xyz", clone.GetStringVariable("tessedit_char_blacklist"));
+
+  file::MakeTmpdir();
+  static const char *kPages[] = {"HelloGoogle.tif", "phototest.tif", "viet.tif",
+                                 "HelloGoogle.tif", "phototest.tif", nullptr};
+  std::string list;
+  for (int i = 0; kPages[i] != nullptr; ++i) {
+    list += TestDataNameToPath(kPages[i]) + "\n";
+  }
+  std::string list_file = file::JoinPath(FLAGS_test_tmpdir, "parallel_pages.txt");
+  CHECK(file::SetContents(list_file, list, file::Defaults()));
+
+  std::string text[2];
+  for (int parallel = 0; parallel < 2; ++parallel) {
+    std::string outputbase =
+        file::JoinPath(FLAGS_test_tmpdir, parallel ? "parallel" : "sequential");
+    api.SetVariable("tessedit_parallel_pages", parallel ? "3" : "1");
+    {
+      tesseract::TessTextRenderer renderer(outputbase.c_str());
+      EXPECT_TRUE(api.ProcessPages(list_file.c_str(), nullptr, 0, &renderer));
+    }
+    CHECK_OK(file::GetContents(outputbase + ".txt", &text[parallel], file::Defaults()));
+  }
+  EXPECT_FALSE(text[0].empty());
+  EXPECT_EQ(text[0], text[1]);
+}
+
+// Jobs submitted to the async API give the same text as synchronous
+// recognition, through both futures and callbacks.
+TEST_F(TesseractTest, AsyncAPITest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng") == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  static const char *kImages[] = {"HelloGoogle.tif", "phototest.tif", "HelloGoogle.tif",
+                                  "phototest.tif", "HelloGoogle.tif", nullptr};
+  std::vector<std::string> expected;
+  for (int i = 0; kImages[i] != nullptr; ++i) {
+    Image src_pix = pixRead(TestDataNameToPath(kImages[i]).c_str());
+    CHECK(src_pix);
+    api.SetImage(src_pix);
+    std::unique_ptr<char[]> text(api.GetUTF8Text());
+    expected.emplace_back(text.get());
+    src_pix.destroy();
+  }
+
+  tesseract::TessAsyncAPI async_api;
+  EXPECT_FALSE(async_api.Submit(nullptr, nullptr));
+  ASSERT_TRUE(async_api.Start(api, 2, 1));
+  EXPECT_EQ(2, async_api.NumWorkers());
+  EXPECT_FALSE(async_api.Start(api, 2, 1));
+
+  std::vector<std::future<tesseract::TessAsyncResult>> futures;
+  std::atomic<int> num_matched(0);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    futures.push_back(async_api.Submit(pixRead(TestDataNameToPath(kImages[i]).c_str())));
+    const std::string &truth = expected[i];
+    EXPECT_TRUE(async_api.Submit(pixRead(TestDataNameToPath(kImages[i]).c_str()),
+                                 [&num_matched, &truth](tesseract::TessBaseAPI *engine, bool ok) {
+                                   std::unique_ptr<char[]> text(engine->GetUTF8Text());
+                                   if (ok && truth == text.get()) {
+                                     ++num_matched;
+                                   }
+                                 }));
+  }
+  for (size_t i = 0; i < futures.size(); ++i) {
+    tesseract::TessAsyncResult result = futures[i].get();
+    EXPECT_TRUE(result.ok);
+    EXPECT_EQ(expected[i], result.text);
+    EXPECT_GT(result.mean_confidence, 0);
+  }
+  async_api.Wait();
+  EXPECT_EQ(static_cast<int>(expected.size()), num_matched.load());
+}
+
+// A callback that throws does not stop its worker, and a callback that
+// submits to a full queue is refused instead of waiting for itself.
+TEST_F(TesseractTest, AsyncAPICallbackTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng") == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  const std::string image = TestDataNameToPath("HelloGoogle.tif");
+  tesseract::TessAsyncAPI async_api;
+  ASSERT_TRUE(async_api.Start(api, 1, 1));
+
+  EXPECT_TRUE(async_api.Submit(pixRead(image.c_str()), [](tesseract::TessBaseAPI *, bool) {
+    throw std::runtime_error("callback failed");
+  }));
+  std::future<tesseract::TessAsyncResult> future = async_api.Submit(pixRead(image.c_str()));
+  EXPECT_TRUE(future.get().ok);
+
+  std::atomic<int> num_queued(0);
+  std::atomic<int> num_refused(0);
+  std::atomic<int> num_done(0);
+  EXPECT_TRUE(async_api.Submit(pixRead(image.c_str()), [&](tesseract::TessBaseAPI *, bool) {
+    // The only worker is busy here, so the first job fills the queue.
+    for (int i = 0; i < 2; ++i) {
+      bool queued = async_api.Submit(pixRead(image.c_str()),
+                                     [&num_done](tesseract::TessBaseAPI *, bool ok) {
+                                       if (ok) {
+                                         ++num_done;
+                                       }
+                                     });
+      ++(queued ? num_queued : num_refused);
+    }
+  }));
+  async_api.Wait();
+  EXPECT_EQ(1, num_queued.load());
+  EXPECT_EQ(1, num_refused.load());
+  EXPECT_EQ(1, num_done.load());
+}
+
 // Tests that Tesseract gets exactly the right answer on some page numbers.
 TEST_F(TesseractTest, AdaptToWordStrTest) {
 #ifdef DISABLED_LEGACY_ENGINE
@@ -223,6 +920,145 @@ TEST_F(TesseractTest, BasicLSTMTest) {
   src_pix.destroy();
 }
 
+// Line images given to RecognizeLines are recognized without layout
+// analysis, and the flat symbol array is consistent with the line text.
+TEST_F(TesseractTest, RecognizeLinesTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  std::vector<Pix *> lines = {src_pix, src_pix};
+  std::vector<tesseract::TessLineResult> results;
+  std::vector<tesseract::TessLineSymbol> symbols;
+  EXPECT_TRUE(api.RecognizeLines(lines, &results, &symbols));
+  ASSERT_EQ(lines.size(), results.size());
+  EXPECT_THAT(results[0].text, HasSubstr("Hello"));
+  EXPECT_EQ(results[0].text, results[1].text);
+  EXPECT_GT(results[0].confidence, 0.0f);
+  EXPECT_EQ(0, results[0].first_symbol);
+  EXPECT_EQ(results[0].num_symbols, results[1].first_symbol);
+  EXPECT_EQ(symbols.size(),
+            static_cast<size_t>(results[0].num_symbols + results[1].num_symbols));
+  int width = pixGetWidth(src_pix);
+  int height = pixGetHeight(src_pix);
+  for (int s = 0; s < results[0].num_symbols; ++s) {
+    const tesseract::TessLineSymbol &symbol = symbols[results[0].first_symbol + s];
+    EXPECT_LE(0, symbol.left);
+    EXPECT_LE(symbol.left, symbol.right);
+    EXPECT_LE(symbol.right, width);
+    EXPECT_LE(0, symbol.top);
+    EXPECT_LE(symbol.bottom, height);
+    EXPECT_LE(static_cast<size_t>(symbol.text_offset + symbol.text_length),
+              results[0].text.size());
+  }
+  // The image was not set on the api.
+  EXPECT_EQ(nullptr, api.GetUTF8Text());
+  src_pix.destroy();
+}
+
+// Without an LSTM model there is nothing to recognize lines with.
+TEST_F(TesseractTest, RecognizeLinesLegacyOnlyTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_TESSERACT_ONLY) == -1) {
+    // eng.traineddata not found or other problem during Init.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  std::vector<Pix *> lines = {src_pix};
+  std::vector<tesseract::TessLineResult> results;
+  EXPECT_FALSE(api.RecognizeLines(lines, &results, nullptr));
+  src_pix.destroy();
+}
+
+// A white-on-black line is recognized through the inverted retry by default,
+// and with lstm_predict_polarity by predicting its polarity, with the same
+// text either way.
+TEST_F(TesseractTest, PredictPolarityTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("HelloGoogle.tif").c_str());
+  CHECK(src_pix);
+  Image inverted_pix = pixInvert(nullptr, src_pix);
+  std::vector<Pix *> lines = {inverted_pix};
+  tesseract::LSTMRecognizer *recognizer = api.tesseract()->lstm_recognizer();
+  ASSERT_TRUE(recognizer != nullptr);
+
+  std::vector<tesseract::TessLineResult> results;
+  recognizer->ResetPolarityCounts();
+  EXPECT_TRUE(api.RecognizeLines(lines, &results, nullptr));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_THAT(results[0].text, HasSubstr("Hello"));
+  std::string default_text = results[0].text;
+  tesseract::PolarityCounts counts = recognizer->polarity_counts();
+  EXPECT_EQ(0, counts.normal);
+  EXPECT_EQ(0, counts.inverted);
+  EXPECT_EQ(1, counts.ambiguous);
+  EXPECT_EQ(1, counts.both_ways);
+  EXPECT_EQ(1, counts.both_ways_inverted);
+
+  EXPECT_TRUE(api.SetVariable("lstm_predict_polarity", "1"));
+  recognizer->ResetPolarityCounts();
+  EXPECT_TRUE(api.RecognizeLines(lines, &results, nullptr));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(default_text, results[0].text);
+  counts = recognizer->polarity_counts();
+  EXPECT_EQ(0, counts.normal);
+  EXPECT_EQ(1, counts.inverted);
+  EXPECT_EQ(0, counts.ambiguous);
+  // If the inverted line was retried as is, the inverted result still won.
+  EXPECT_EQ(counts.both_ways, counts.both_ways_inverted);
+  inverted_pix.destroy();
+  src_pix.destroy();
+}
+
+// RecognizeRegions gives the same results on one engine and on several,
+// and reports rectangles outside the image as failed.
+TEST_F(TesseractTest, RecognizeRegionsTest) {
+  tesseract::TessBaseAPI api;
+  if (api.Init(TessdataPath().c_str(), "eng", tesseract::OEM_LSTM_ONLY) == -1) {
+    // eng.traineddata not found.
+    GTEST_SKIP();
+  }
+  Image src_pix = pixRead(TestDataNameToPath("phototest.tif").c_str());
+  CHECK(src_pix);
+  int width = pixGetWidth(src_pix);
+  int height = pixGetHeight(src_pix);
+  Boxa *regions = boxaCreate(4);
+  boxaAddBox(regions, boxCreate(0, 0, width, height), L_INSERT);
+  boxaAddBox(regions, boxCreate(0, 0, width, height / 2), L_INSERT);
+  boxaAddBox(regions, boxCreate(width + 10, height + 10, 20, 20), L_INSERT);
+  boxaAddBox(regions, boxCreate(0, height / 2, width, height - height / 2), L_INSERT);
+  api.SetImage(src_pix);
+  std::vector<tesseract::TessRegionResult> serial;
+  EXPECT_TRUE(api.RecognizeRegions(regions, 1, &serial));
+  ASSERT_EQ(4u, serial.size());
+  EXPECT_TRUE(serial[0].ok);
+  EXPECT_THAT(serial[0].text, HasSubstr("This is a lot of 12 point text"));
+  EXPECT_GT(serial[0].mean_confidence, 0);
+  EXPECT_FALSE(serial[2].ok);
+  std::vector<tesseract::TessRegionResult> parallel;
+  EXPECT_TRUE(api.RecognizeRegions(regions, 3, &parallel));
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (size_t i = 0; i < serial.size(); ++i) {
+    EXPECT_EQ(serial[i].ok, parallel[i].ok);
+    EXPECT_EQ(serial[i].text, parallel[i].text);
+  }
+  // The whole image can still be recognized afterwards.
+  char *text = api.GetUTF8Text();
+  ASSERT_TRUE(text != nullptr);
+  EXPECT_EQ(serial[0].text, text);
+  delete[] text;
+  boxaDestroy(&regions);
+  src_pix.destroy();
+}
+
 // Test that LSTM's character bounding boxes are properly converted to
 // Tesseract structures. Note that we can't guarantee that LSTM's
 // character boxes fall completely within Tesseract's word box because
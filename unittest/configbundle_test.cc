@@ -0,0 +1,112 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "configbundle.h"
+#include "serialis.h"
+
+#include "include_gunit.h"
+
+#include <cstring> // for strlen
+
+namespace tesseract {
+
+class ConfigBundleTest : public ::testing::Test {
+protected:
+  ConfigBundleTest()
+      : int_param_(0, "bundle_test_int", "", false, &params_)
+      , bool_param_(false, "bundle_test_bool", "", false, &params_)
+      , string_param_("", "bundle_test_string", "", false, &params_)
+      , double_param_(0.0, "bundle_test_double", "", false, &params_) {}
+
+  bool AddConfig(ConfigBundle *bundle, const char *name, const char *text) {
+    TFile fp;
+    fp.Open(text, strlen(text));
+    return bundle->AddConfig(name, &fp, &params_);
+  }
+
+  ParamsVectors params_;
+  IntParam int_param_;
+  BoolParam bool_param_;
+  StringParam string_param_;
+  DoubleParam double_param_;
+};
+
+// Tests that a bundled config survives serialization and sets the same
+// values as the text config it was built from.
+TEST_F(ConfigBundleTest, RoundTrip) {
+  ConfigBundle bundle;
+  EXPECT_TRUE(AddConfig(&bundle, "test",
+                        "# A comment\n"
+                        "bundle_test_int 42\n"
+                        "\n"
+                        "bundle_test_bool T\n"
+                        "bundle_test_string some words\n"
+                        "bundle_test_double\t0.25\n"));
+  std::vector<char> data;
+  TFile fp;
+  fp.OpenWrite(&data);
+  EXPECT_TRUE(bundle.Serialize(&fp));
+
+  ConfigBundle loaded;
+  fp.Open(&data[0], data.size());
+  EXPECT_TRUE(loaded.DeSerialize(&fp));
+  EXPECT_TRUE(loaded.HasConfig("test"));
+  EXPECT_FALSE(loaded.HasConfig("other"));
+  EXPECT_TRUE(loaded.Resolve(&params_));
+  EXPECT_TRUE(loaded.Apply("test", SET_PARAM_CONSTRAINT_NONE));
+  EXPECT_EQ(42, int_param_);
+  EXPECT_TRUE(bool_param_);
+  EXPECT_STREQ("some words", string_param_.c_str());
+  EXPECT_DOUBLE_EQ(0.25, double_param_);
+  EXPECT_FALSE(loaded.Apply("other", SET_PARAM_CONSTRAINT_NONE));
+}
+
+// Tests that parameters that cannot be resolved are reported by Resolve and
+// Apply, and that the others are still set.
+TEST_F(ConfigBundleTest, UnresolvedParams) {
+  ConfigBundle bundle;
+  EXPECT_TRUE(AddConfig(&bundle, "test", "bundle_test_int 42\n"));
+  ParamsVectors other_params;
+  IntParam other_int(0, "bundle_test_int", "", false, &other_params);
+  ParamsVectors no_params;
+  EXPECT_FALSE(bundle.Resolve(&no_params));
+  EXPECT_FALSE(bundle.Apply("test", SET_PARAM_CONSTRAINT_NONE));
+  EXPECT_EQ(0, int_param_);
+  EXPECT_TRUE(bundle.Resolve(&other_params));
+  EXPECT_TRUE(bundle.Apply("test", SET_PARAM_CONSTRAINT_NONE));
+  EXPECT_EQ(42, other_int);
+  EXPECT_EQ(0, int_param_);
+}
+
+// Tests that unknown names and bad values are rejected when building.
+TEST_F(ConfigBundleTest, RejectsInvalidConfigs) {
+  ConfigBundle bundle;
+  EXPECT_FALSE(AddConfig(&bundle, "unknown", "bundle_test_no_such_param 1\n"));
+  EXPECT_FALSE(AddConfig(&bundle, "int", "bundle_test_int forty-two\n"));
+  EXPECT_FALSE(AddConfig(&bundle, "bool", "bundle_test_bool maybe\n"));
+  EXPECT_FALSE(AddConfig(&bundle, "double", "bundle_test_double 0.5x\n"));
+  EXPECT_TRUE(bundle.empty());
+}
+
+// Tests that a truncated bundle is rejected without changing the contents.
+TEST_F(ConfigBundleTest, RejectsTruncatedData) {
+  ConfigBundle bundle;
+  EXPECT_TRUE(AddConfig(&bundle, "test", "bundle_test_string abc\n"));
+  std::vector<char> data;
+  TFile fp;
+  fp.OpenWrite(&data);
+  EXPECT_TRUE(bundle.Serialize(&fp));
+
+  fp.Open(&data[0], data.size() - 1);
+  EXPECT_FALSE(bundle.DeSerialize(&fp));
+  EXPECT_TRUE(bundle.HasConfig("test"));
+}
+
+} // namespace tesseract
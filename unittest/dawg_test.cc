@@ -11,6 +11,7 @@
 
 #include "include_gunit.h"
 
+#include "dawg_cache.h"
 #include "ratngs.h"
 #include "trie.h"
 #include "unicharset.h"
@@ -107,4 +108,41 @@ TEST_F(DawgTest, TestMatching) {
   EXPECT_TRUE(trie.prefix_in_dawg(space_apos, true));
 }
 
+TEST_F(DawgTest, TestSquishedDawgFromFile) {
+  UNICHARSET unicharset;
+  unicharset.load_from_file(file::JoinPath(TESTING_DIR, "eng.unicharset").c_str());
+  std::string wordlist = file::JoinPath(TESTING_DIR, "eng.wordlist.clean.freq");
+  std::string dawg_file = OutputNameToPath("user-words.dawg");
+  tesseract::Trie trie(tesseract::DAWG_TYPE_WORD, "eng", USER_DAWG_PERM, unicharset.size(), 0);
+  ASSERT_TRUE(trie.read_and_add_word_list(wordlist.c_str(), unicharset,
+                                          tesseract::Trie::RRP_DO_NO_REVERSE));
+  std::unique_ptr<SquishedDawg> squished(trie.trie_to_dawg());
+  ASSERT_TRUE(squished->write_squished_dawg(dawg_file.c_str()));
+
+  EXPECT_TRUE(SquishedDawg::IsSquishedDawgFile(dawg_file.c_str()));
+  EXPECT_FALSE(SquishedDawg::IsSquishedDawgFile(wordlist.c_str()));
+
+  DawgCache cache;
+  Dawg *dawg = cache.GetSquishedDawgFromFile("eng", dawg_file, DAWG_TYPE_WORD, USER_DAWG_PERM,
+                                             unicharset.size(), 0);
+  ASSERT_TRUE(dawg != nullptr);
+  // A second request shares the cached copy.
+  EXPECT_EQ(dawg, cache.GetSquishedDawgFromFile("eng", dawg_file, DAWG_TYPE_WORD,
+                                                USER_DAWG_PERM, unicharset.size(), 0));
+  EXPECT_EQ(USER_DAWG_PERM, dawg->permuter());
+  std::set<std::string> words;
+  LoadWordlist(wordlist, &words);
+  for (const auto &word : words) {
+    WERD_CHOICE choice(word.c_str(), unicharset);
+    if (!choice.empty() && !choice.contains_unichar_id(INVALID_UNICHAR_ID)) {
+      EXPECT_TRUE(dawg->word_in_dawg(choice)) << word;
+    }
+  }
+  // A unicharset of the wrong size is rejected.
+  EXPECT_TRUE(cache.GetSquishedDawgFromFile("eng", dawg_file, DAWG_TYPE_WORD, USER_DAWG_PERM,
+                                            unicharset.size() + 1, 0) == nullptr);
+  EXPECT_TRUE(cache.FreeDawg(dawg));
+  EXPECT_TRUE(cache.FreeDawg(dawg));
+}
+
 } // namespace tesseract
@@ -33,10 +33,14 @@ protected:
 };
 
 #ifndef DISABLED_LEGACY_ENGINE
-static void OSDTester(int expected_deg, const char *imgname, const char *tessdatadir) {
+static void OSDTester(int expected_deg, const char *imgname, const char *tessdatadir,
+                      bool fast = false) {
   // log.info() << tessdatadir << " for image: " << imgname << std::endl;
   auto api = std::make_unique<tesseract::TessBaseAPI>();
   ASSERT_FALSE(api->Init(tessdatadir, "osd")) << "Could not initialize tesseract.";
+  if (fast) {
+    api->SetVariable("osd_fast", "1");
+  }
   Image image = pixRead(imgname);
   ASSERT_TRUE(image != nullptr) << "Failed to read test image.";
   api->SetImage(image);
@@ -70,6 +74,15 @@ TEST_P(OSDTest, MatchOrientationDegrees) {
 #endif
 }
 
+TEST_P(OSDTest, FastMatchOrientationDegrees) {
+#ifdef DISABLED_LEGACY_ENGINE
+  // Skip test because TessBaseAPI::DetectOrientationScript is missing.
+  GTEST_SKIP();
+#else
+  OSDTester(std::get<0>(GetParam()), std::get<1>(GetParam()), std::get<2>(GetParam()), true);
+#endif
+}
+
 INSTANTIATE_TEST_SUITE_P(TessdataEngEuroHebrew, OSDTest,
                          ::testing::Combine(::testing::Values(0),
                                             ::testing::Values(TESTING_DIR "/phototest.tif",
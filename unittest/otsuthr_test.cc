@@ -0,0 +1,159 @@
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <allheaders.h>
+
+#include <algorithm> // for std::fill
+
+#include "helpers.h"
+#include "image.h"
+#include "otsuthr.h"
+#include "thresholder.h"
+
+#include "include_gunit.h"
+
+namespace tesseract {
+
+const int kImageWidth = 101;
+const int kImageHeight = 23;
+
+class OtsuThrTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::locale::global(std::locale(""));
+    rand_.set_seed(1234);
+  }
+
+  // Makes an image of the given depth whose bytes are either dark or light,
+  // so every channel has two clear modes for Otsu to separate.
+  Image MakeImage(int depth) {
+    Image pix = pixCreate(kImageWidth, kImageHeight, depth);
+    int num_channels = depth / 8;
+    int wpl = pixGetWpl(pix);
+    uint32_t *data = pixGetData(pix);
+    for (int y = 0; y < kImageHeight; ++y) {
+      uint32_t *line = data + y * wpl;
+      for (int n = 0; n < kImageWidth * num_channels; ++n) {
+        int value = rand_.IntRand() % 80;
+        Image::setDataByte(line, n, rand_.IntRand() % 3 == 0 ? value : 255 - value);
+      }
+    }
+    return pix;
+  }
+
+  // Computes the histogram of one channel of the rectangle a pixel at a time.
+  static void ReferenceHistogram(Image pix, int channel, int left, int top, int width,
+                                 int height, int *histogram) {
+    int num_channels = pixGetDepth(pix) / 8;
+    int wpl = pixGetWpl(pix);
+    const uint32_t *data = pixGetData(pix);
+    std::fill(histogram, histogram + kHistogramSize, 0);
+    for (int y = top; y < top + height; ++y) {
+      const uint32_t *line = data + y * wpl;
+      for (int x = left; x < left + width; ++x) {
+        ++histogram[Image::getDataByte(line, x * num_channels + channel)];
+      }
+    }
+  }
+
+  // Checks HistogramRectChannels and HistogramRect against ReferenceHistogram
+  // for the given rectangle.
+  static void ExpectHistograms(Image pix, int left, int top, int width, int height) {
+    int num_channels = pixGetDepth(pix) / 8;
+    std::vector<int> histograms(num_channels * kHistogramSize);
+    HistogramRectChannels(pix, left, top, width, height, histograms.data());
+    for (int ch = 0; ch < num_channels; ++ch) {
+      int expected[kHistogramSize];
+      int single[kHistogramSize];
+      ReferenceHistogram(pix, ch, left, top, width, height, expected);
+      HistogramRect(pix, ch, left, top, width, height, single);
+      for (int value = 0; value < kHistogramSize; ++value) {
+        EXPECT_EQ(expected[value], histograms[ch * kHistogramSize + value])
+            << "depth=" << pixGetDepth(pix) << " left=" << left << " width=" << width
+            << " ch=" << ch << " value=" << value;
+        EXPECT_EQ(expected[value], single[value]);
+      }
+    }
+  }
+
+  // Thresholds the rectangle with ImageThresholder and checks every output
+  // pixel, and the padding after the last pixel of each row, against the
+  // thresholds and hi_values that OtsuThreshold computes for it.
+  static void ExpectThresholded(Image pix, int left, int top, int width, int height) {
+    std::vector<int> thresholds;
+    std::vector<int> hi_values;
+    int num_channels = OtsuThreshold(pix, left, top, width, height, thresholds, hi_values);
+    ASSERT_EQ(pixGetDepth(pix) / 8, num_channels);
+
+    ImageThresholder thresholder;
+    thresholder.SetImage(pix);
+    thresholder.SetRectangle(left, top, width, height);
+    Image binary = nullptr;
+    ASSERT_TRUE(thresholder.ThresholdToPix(&binary));
+    ASSERT_EQ(width, pixGetWidth(binary));
+    ASSERT_EQ(height, pixGetHeight(binary));
+
+    int src_wpl = pixGetWpl(pix);
+    const uint32_t *src_data = pixGetData(pix);
+    int wpl = pixGetWpl(binary);
+    const uint32_t *data = pixGetData(binary);
+    for (int y = 0; y < height; ++y) {
+      const uint32_t *src_line = src_data + (top + y) * src_wpl;
+      const uint32_t *line = data + y * wpl;
+      for (int x = 0; x < width; ++x) {
+        bool black = false;
+        for (int ch = 0; ch < num_channels; ++ch) {
+          int value = Image::getDataByte(src_line, (left + x) * num_channels + ch);
+          if (hi_values[ch] >= 0 && (value > thresholds[ch]) == (hi_values[ch] == 0)) {
+            black = true;
+          }
+        }
+        uint32_t bit = (line[x >> 5] >> (31 - (x & 31))) & 1;
+        EXPECT_EQ(black ? 1u : 0u, bit) << "width=" << width << " x=" << x << " y=" << y;
+      }
+      int tail = width & 31;
+      if (tail != 0) {
+        uint32_t padding = line[width >> 5] & (0xffffffffu >> tail);
+        EXPECT_EQ(0u, padding) << "width=" << width << " y=" << y;
+      }
+    }
+    binary.destroy();
+  }
+
+  TRand rand_;
+};
+
+TEST_F(OtsuThrTest, HistogramRectChannels) {
+  for (int depth : {8, 16, 32}) {
+    Image pix = MakeImage(depth);
+    ExpectHistograms(pix, 0, 0, kImageWidth, kImageHeight);
+    for (int left : {1, 3, 7}) {
+      for (int width : {1, 5, 33, 61}) {
+        ExpectHistograms(pix, left, 2, width, kImageHeight - 5);
+      }
+    }
+    pix.destroy();
+  }
+}
+
+TEST_F(OtsuThrTest, ThresholdRectToPix) {
+  for (int depth : {8, 16, 32}) {
+    Image pix = MakeImage(depth);
+    ExpectThresholded(pix, 0, 0, kImageWidth, kImageHeight);
+    for (int left : {1, 5}) {
+      for (int width : {1, 31, 33, 67, 95}) {
+        ExpectThresholded(pix, left, 3, width, kImageHeight - 4);
+      }
+    }
+    pix.destroy();
+  }
+}
+
+} // namespace tesseract
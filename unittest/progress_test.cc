@@ -29,6 +29,7 @@
 #include <locale>
 #include <memory> // std::unique_ptr
 #include <string>
+#include <thread> // std::this_thread
 
 #include <time.h>
 
@@ -144,6 +145,45 @@ void NewProgressTester(const char *imgname, const char *tessdatadir, const char
   image.destroy();
 }
 
+void BudgetTester(const char *imgname, const char *tessdatadir, const char *lang) {
+  using ::testing::HasSubstr;
+
+  auto api = std::make_unique<tesseract::TessBaseAPI>();
+  ASSERT_FALSE(api->Init(tessdatadir, lang)) << "Could not initialize tesseract.";
+  Image image = pixRead(imgname);
+  ASSERT_TRUE(image != nullptr) << "Failed to read test image.";
+
+  // An ample budget changes nothing.
+  ASSERT_TRUE(api->SetVariable("tessedit_time_budget_msecs", "600000"));
+  api->SetImage(image);
+  EXPECT_EQ(api->Recognize(nullptr), 0);
+  EXPECT_EQ(api->GetDegradations(), 0);
+  std::unique_ptr<char[]> text(api->GetUTF8Text());
+  EXPECT_THAT(text.get(), HasSubstr("12 point"));
+
+  // A spent budget degrades recognition instead of stopping it.
+  ASSERT_TRUE(api->SetVariable("tessedit_time_budget_msecs", "1"));
+  api->SetImage(image);
+  ETEXT_DESC monitor;
+  EXPECT_EQ(api->Recognize(&monitor), 0);
+  EXPECT_NE(api->GetDegradations() & DEGRADE_NO_INVERT, 0);
+  EXPECT_NE(api->GetDegradations() & DEGRADE_NO_DICT, 0);
+  EXPECT_NE(api->GetDegradations() & DEGRADE_NARROW_BEAM, 0);
+  text.reset(api->GetUTF8Text());
+  EXPECT_THAT(text.get(), HasSubstr("12 point"));
+
+  // A blank page, which never gets to word recognition, does not report
+  // the degradations of the last page.
+  Image blank = pixCreate(200, 100, 1);
+  api->SetImage(blank);
+  EXPECT_EQ(api->Recognize(nullptr), 0);
+  EXPECT_EQ(api->GetDegradations(), 0);
+  blank.destroy();
+
+  api->End();
+  image.destroy();
+}
+
 TEST(QuickTest, ClassicProgressReporting) {
   ClassicProgressTester(TESTING_DIR "/phototest.tif", TESSDATA_DIR "_fast", "eng");
 }
@@ -152,4 +192,8 @@ TEST(QuickTest, NewProgressReporting) {
   NewProgressTester(TESTING_DIR "/phototest.tif", TESSDATA_DIR "_fast", "eng");
 }
 
+TEST(QuickTest, TimeBudget) {
+  BudgetTester(TESTING_DIR "/phototest.tif", TESSDATA_DIR "_fast", "eng");
+}
+
 } // namespace tesseract
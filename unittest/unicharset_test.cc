@@ -9,6 +9,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "unicharmap.h"
 #include "unicharset.h"
 #include <string>
 #include "gmock/gmock.h" // for testing::ElementsAreArray
@@ -144,6 +145,63 @@ TEST(UnicharsetTest, MultibyteBigrams) {
   EXPECT_EQ(v.unichar_to_id("\u0ccd\u0cad"), 7);
 }
 
+TEST(UnicharsetTest, UnicharMap) {
+  // This test verifies the UNICHARMAP lookups on single and multi byte
+  // codepoints, multi-codepoint unichars and prefixes of them.
+  UNICHARMAP map;
+  EXPECT_FALSE(map.contains("a", 1));
+  EXPECT_EQ(map.minmatch("a"), 0);
+  map.insert("a", 1);
+  map.insert("\u00e9", 2);      // 2 byte codepoint.
+  map.insert("\u4e2d", 3);      // 3 byte codepoint.
+  map.insert("\U0001f600", 4);  // 4 byte codepoint.
+  map.insert("fi", 5);           // 2 codepoints.
+  map.insert("\u0ccd\u0c9c", 6); // 2 codepoints of 3 bytes.
+  EXPECT_EQ(map.unichar_to_id("a", 1), 1);
+  EXPECT_EQ(map.unichar_to_id("\u00e9", 2), 2);
+  EXPECT_EQ(map.unichar_to_id("\u4e2d", 3), 3);
+  EXPECT_EQ(map.unichar_to_id("\U0001f600", 4), 4);
+  EXPECT_EQ(map.unichar_to_id("fi", 2), 5);
+  EXPECT_EQ(map.unichar_to_id("\u0ccd\u0c9c", 6), 6);
+  // Only the given length is used, and a null ends the representation.
+  EXPECT_EQ(map.unichar_to_id("ab", 1), 1);
+  EXPECT_EQ(map.unichar_to_id("\u4e2d\u4e2d", 3), 3);
+  EXPECT_EQ(map.unichar_to_id("\u4e2d", UNICHAR_LEN), 3);
+  EXPECT_EQ(map.unichar_to_id("fi", UNICHAR_LEN), 5);
+  // Missing unichars, including prefixes of present ones.
+  EXPECT_EQ(map.unichar_to_id("b", 1), INVALID_UNICHAR_ID);
+  EXPECT_EQ(map.unichar_to_id("f", 1), INVALID_UNICHAR_ID);
+  EXPECT_EQ(map.unichar_to_id("\u4e2e", 3), INVALID_UNICHAR_ID);
+  EXPECT_EQ(map.unichar_to_id("\u0ccd", 3), INVALID_UNICHAR_ID);
+  EXPECT_FALSE(map.contains("\u4e2d", 2));
+  EXPECT_FALSE(map.contains("fi", UNICHAR_LEN + 1));
+  EXPECT_TRUE(map.contains("\u0ccd\u0c9c", 6));
+  // Truncated sequences are not read past their terminating null.
+  const char truncated3[] = {'\xe4', '\0'};
+  const char truncated4[] = {'\xf0', '\x9f', '\x98', '\0'};
+  EXPECT_EQ(map.unichar_to_id(truncated3, UNICHAR_LEN), INVALID_UNICHAR_ID);
+  EXPECT_EQ(map.unichar_to_id(truncated4, UNICHAR_LEN), INVALID_UNICHAR_ID);
+  // An overlong encoding of 'a' is a distinct (invalid) unichar.
+  EXPECT_EQ(map.unichar_to_id("\xc1\xa1", 2), INVALID_UNICHAR_ID);
+  map.insert("\xc1\xa1", 7);
+  EXPECT_EQ(map.unichar_to_id("\xc1\xa1", 2), 7);
+  EXPECT_EQ(map.unichar_to_id("a", 1), 1);
+  // Ids can be replaced.
+  map.insert("\u4e2d", 8);
+  EXPECT_EQ(map.unichar_to_id("\u4e2d", 3), 8);
+  // minmatch finds the shortest present prefix.
+  EXPECT_EQ(map.minmatch("abc"), 1);
+  EXPECT_EQ(map.minmatch("fix"), 2);
+  EXPECT_EQ(map.minmatch("\u4e2dx"), 3);
+  EXPECT_EQ(map.minmatch("\u0ccd\u0c9cx"), 6);
+  EXPECT_EQ(map.minmatch("f"), 0);
+  EXPECT_EQ(map.minmatch("xyz"), 0);
+  map.clear();
+  EXPECT_FALSE(map.contains("a", 1));
+  EXPECT_FALSE(map.contains("\u4e2d", 3));
+  EXPECT_FALSE(map.contains("fi", 2));
+}
+
 TEST(UnicharsetTest, OldStyle) {
   // This test verifies an old unicharset that contains fi/fl ligatures loads
   // and keeps all the entries.